@@ -0,0 +1,42 @@
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+
+// Replacement global allocation functions that count every call, for ListPoolBenchmark.
+// They are kept out of the benchmark's translation unit so the compiler never inlines a
+// free() next to a new-expression and takes the pair for a mismatched deallocation.
+long long allocationCount = 0;
+
+namespace {
+
+void* allocate(std::size_t bytes) {
+    ++allocationCount;
+    if (void* ptr = std::malloc(bytes ? bytes : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+// aligned_alloc needs the size to be a multiple of the alignment.
+void* allocate(std::size_t bytes, std::align_val_t alignment) {
+    ++allocationCount;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    std::size_t rounded = (std::max<std::size_t>(bytes, 1) + align - 1) / align * align;
+    if (void* ptr = std::aligned_alloc(align, rounded)) return ptr;
+    throw std::bad_alloc();
+}
+
+}
+
+void* operator new(std::size_t bytes) { return allocate(bytes); }
+void* operator new[](std::size_t bytes) { return allocate(bytes); }
+void* operator new(std::size_t bytes, std::align_val_t alignment) { return allocate(bytes, alignment); }
+void* operator new[](std::size_t bytes, std::align_val_t alignment) { return allocate(bytes, alignment); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
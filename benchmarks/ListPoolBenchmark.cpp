@@ -0,0 +1,77 @@
+#include "../headers/LinkedList.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+
+// Counted by the replacement operator new in AllocationCounter.cpp.
+extern long long allocationCount;
+static long long checksum = 0;
+
+
+template <typename F>
+void report(const std::string& type, const std::string& allocator, const std::string& phase, F run) {
+    long long before = allocationCount;
+    auto start = std::chrono::steady_clock::now();
+    run();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::left << std::setw(10) << type << std::setw(12) << allocator << std::setw(12) << phase
+              << std::setw(14) << allocationCount - before << ms << "\n";
+}
+
+// Builds a list from both ends, walks it, destroys it, then builds and clears it again.
+template <typename T, typename Allocator, typename Make>
+void benchmarkList(const std::string& type, const std::string& allocator, int count, Make make) {
+    LinkedList<T, Allocator>* list = nullptr;
+    report(type, allocator, "build", [&] {
+        list = new LinkedList<T, Allocator>();
+        for (int i = 0; i < count; ++i) {
+            if (i % 2 == 0) {
+                list->Append(make(i));
+            } else {
+                list->Prepend(make(i));
+            }
+        }
+    });
+
+    report(type, allocator, "traverse", [&] {
+        for (const T& item : *list) {
+            checksum += static_cast<long long>(sizeof(item));
+        }
+    });
+
+    report(type, allocator, "refill", [&] {
+        for (int round = 0; round < 4; ++round) {
+            list->Clear();
+            for (int i = 0; i < count; ++i) {
+                list->Append(make(i));
+            }
+        }
+    });
+
+    report(type, allocator, "destroy", [&] {
+        delete list;
+    });
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    std::cout << std::left << std::setw(10) << "type" << std::setw(12) << "allocator" << std::setw(12) << "phase"
+              << std::setw(14) << "allocations" << "ms\n";
+
+    auto makeInt = [](int i) { return i; };
+    benchmarkList<int, std::allocator<int>>("int", "new", count, makeInt);
+    benchmarkList<int, PoolAllocator<int>>("int", "pool", count, makeInt);
+
+    auto makeString = [](int i) { return std::string(24, static_cast<char>('a' + i % 26)); };
+    benchmarkList<std::string, std::allocator<std::string>>("string", "new", count, makeString);
+    benchmarkList<std::string, PoolAllocator<std::string>>("string", "pool", count, makeString);
+
+    std::cout << "checksum " << checksum << "\n";
+
+    return 0;
+}
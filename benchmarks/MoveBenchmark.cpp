@@ -0,0 +1,87 @@
+#include "../headers/Sequence.hpp"
+#include "../headers/SegmentedSequence.hpp"
+#include "../headers/AdaptiveSequence.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+
+
+static long long allocationCount = 0;
+
+void* operator new(std::size_t bytes) {
+    ++allocationCount;
+    if (void* ptr = std::malloc(bytes ? bytes : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t bytes) {
+    ++allocationCount;
+    if (void* ptr = std::malloc(bytes ? bytes : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+
+enum class Mode { Copy, Move, Emplace };
+
+template <typename F>
+void report(const std::string& name, const std::string& mode, F fill) {
+    long long before = allocationCount;
+    auto start = std::chrono::steady_clock::now();
+    fill();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::left << std::setw(28) << name << std::setw(10) << mode
+              << std::setw(14) << allocationCount - before << ms << "\n";
+}
+
+void benchmarkSequence(const std::string& name, Sequence<std::string>* (*create)(), int count) {
+    const std::string payload(64, 'p');
+
+    const char* modes[] = {"copy", "move", "emplace"};
+    for (Mode mode : {Mode::Copy, Mode::Move, Mode::Emplace}) {
+        report(name, modes[static_cast<int>(mode)], [&] {
+            Sequence<std::string>* seq = create();
+            for (int i = 0; i < count; ++i) {
+                if (mode == Mode::Copy) {
+                    std::string item(payload);
+                    seq->Append(item);
+                } else if (mode == Mode::Move) {
+                    std::string item(payload);
+                    seq->Append(std::move(item));
+                } else {
+                    seq->EmplaceBack(payload);
+                }
+            }
+            delete seq;
+        });
+    }
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    std::cout << std::left << std::setw(28) << "sequence" << std::setw(10) << "mode"
+              << std::setw(14) << "allocations" << "ms\n";
+
+    benchmarkSequence("MutableArraySequence", [] () -> Sequence<std::string>* {
+        return new MutableArraySequence<std::string>();
+    }, count);
+    benchmarkSequence("MutableListSequence", [] () -> Sequence<std::string>* {
+        return new MutableListSequence<std::string>();
+    }, count);
+    benchmarkSequence("MutableAdaptiveSequence", [] () -> Sequence<std::string>* {
+        return new MutableAdaptiveSequence<std::string>();
+    }, count);
+    benchmarkSequence("MutableSegmentedSequence", [] () -> Sequence<std::string>* {
+        return new MutableSegmentedSequence<std::string>(1024);
+    }, count);
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "../headers/Sequence.hpp"
+#include "../headers/SegmentedSequence.hpp"
+#include "../headers/AdaptiveSequence.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+
+template <typename F>
+double measure(F action) {
+    auto start = std::chrono::steady_clock::now();
+    action();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void benchmarkSequence(const std::string& name, Sequence<double>* seq) {
+    auto mapper = [](const double& x) { return std::sqrt(x) * 1.5 + 1.0; };
+    auto wherer = [](const double& x) { return static_cast<long long>(x) % 3 == 0; };
+    auto reducer = [](const double& a, const double& b) { return a + b; };
+
+    int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        ThreadPool pool(threads);
+        ParallelPolicy policy;
+        policy.pool = &pool;
+
+        Sequence<double>* mapped = nullptr;
+        Sequence<double>* filtered = nullptr;
+        double sum = 0;
+        double mapTime = measure([&] { mapped = seq->Map(policy, mapper); });
+        double whereTime = measure([&] { filtered = seq->Where(policy, wherer); });
+        double reduceTime = measure([&] { sum = seq->Reduce(policy, reducer, 0.0); });
+
+        std::cout << std::left << std::setw(28) << name << std::setw(8) << threads
+                  << std::setw(12) << mapTime << std::setw(12) << whereTime << std::setw(12) << reduceTime
+                  << filtered->GetLength() << " " << sum << "\n";
+
+        delete mapped;
+        delete filtered;
+    }
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 10000000;
+
+    double* items = new double[count];
+    for (int i = 0; i < count; ++i) {
+        items[i] = i;
+    }
+
+    std::cout << std::left << std::setw(28) << "sequence" << std::setw(8) << "threads"
+              << std::setw(12) << "map ms" << std::setw(12) << "where ms" << std::setw(12) << "reduce ms" << "check\n";
+
+    Sequence<double>* array = new MutableArraySequence<double>(items, count);
+    benchmarkSequence("MutableArraySequence", array);
+    delete array;
+
+    Sequence<double>* adaptive = new MutableAdaptiveSequence<double>(items, count);
+    benchmarkSequence("MutableAdaptiveSequence", adaptive);
+    delete adaptive;
+
+    Sequence<double>* segmented = new MutableSegmentedSequence<double>(items, count, 4096);
+    benchmarkSequence("MutableSegmentedSequence", segmented);
+    delete segmented;
+
+    delete[] items;
+    return 0;
+}
@@ -0,0 +1,496 @@
+#include "../headers/Sequence.hpp"
+#include "../headers/SegmentedSequence.hpp"
+#include "../headers/AdaptiveSequence.hpp"
+#include "../headers/UnrolledListSequence.hpp"
+#include "../headers/Instrumentation.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+
+// Non-interactive benchmark of every concrete sequence. Each operation runs on a sequence
+// of the given size: per-element operations (Append, Prepend, InsertAt, Get) repeat until
+// maxOps or the time budget is reached, whole-sequence operations run once over all of it.
+// Results are per element, the best and the mean over the repetitions. Builds with
+// SEQUENCES_INSTRUMENTATION also report the counters of the last repetition.
+//
+//   SequenceBenchmark [--format=table|csv|json] [--min-size=N] [--max-size=N]
+//                     [--repetitions=N] [--max-ops=N] [--budget-ms=N] [--filter=TEXT]
+
+struct Options {
+    std::string format = "table";
+    long long minSize = 100;
+    long long maxSize = 10000000;
+    int repetitions = 3;
+    int maxOps = 100000;
+    double budgetMs = 200;
+    std::string filter;
+};
+
+struct Result {
+    std::string sequence;
+    std::string type;
+    std::string operation;
+    int size;
+    int items;
+    int repetitions;
+    double bestNs;
+    double meanNs;
+    SequenceStats counters;
+};
+
+static volatile std::size_t sink = 0;
+
+static const char* const operations[] = {
+    "Append", "Prepend", "InsertAt", "Get", "ForEach", "Visit", "Concat", "GetSubsequence", "Map", "Where", "Reduce",
+};
+
+static bool selected(const Options& options, const std::string& sequence, const std::string& type,
+                     const std::string& operation, long long size) {
+    if (options.filter.empty()) {
+        return true;
+    }
+    std::string name = sequence + "<" + type + ">/" + operation + "/" + std::to_string(size);
+    return name.find(options.filter) != std::string::npos;
+}
+
+
+template <typename T>
+struct Workload;
+
+template <>
+struct Workload<int> {
+    static const char* Name() { return "int"; }
+    static int Make(int i) { return static_cast<int>((i * 2654435761u) >> 4); }
+    static int Map(const int& x) { return x * 3 + 1; }
+    static bool Keep(const int& x) { return x % 3 == 0; }
+    static int Combine(const int& a, const int& b) { return a ^ b; }
+    static std::size_t Digest(const int& x) { return static_cast<std::size_t>(x); }
+};
+
+template <>
+struct Workload<double> {
+    static const char* Name() { return "double"; }
+    static double Make(int i) { return i * 0.5 + 0.25; }
+    static double Map(const double& x) { return x * 1.5 + 1.0; }
+    static bool Keep(const double& x) { return static_cast<long long>(x) % 3 == 0; }
+    static double Combine(const double& a, const double& b) { return a + b; }
+    static std::size_t Digest(const double& x) { return static_cast<std::size_t>(x); }
+};
+
+// Long enough to live on the heap, so copies cost what real strings cost.
+template <>
+struct Workload<std::string> {
+    static const char* Name() { return "string"; }
+    static std::string Make(int i) { return std::string(16, static_cast<char>('a' + i % 26)) + std::to_string(i); }
+    static std::string Map(const std::string& x) { return x + "!"; }
+    static bool Keep(const std::string& x) { return x.back() % 3 == 0; }
+    static std::string Combine(const std::string& a, const std::string& b) { return a.size() >= b.size() ? a : b; }
+    static std::size_t Digest(const std::string& x) { return x.size(); }
+};
+
+
+template <typename T>
+struct Implementation {
+    std::string name;
+    std::function<Sequence<T>*(const T*, int)> create;
+    std::function<std::size_t(const Sequence<T>&)> visit;
+};
+
+// The ForEach workload through StaticSequence::Visit on the concrete type, so that the
+// per-element call is inlined instead of going through std::function.
+template <typename S>
+std::size_t visitStatic(const Sequence<typename S::value_type>& sequence) {
+    using W = Workload<typename S::value_type>;
+    std::size_t digest = 0;
+    static_cast<const S&>(sequence).Visit([&digest](const typename S::value_type& item) {
+        digest += W::Digest(item);
+    });
+    return digest;
+}
+
+template <typename T>
+std::vector<Implementation<T>> implementations() {
+    const int segmentSize = 1024;
+    return {
+        {"MutableArraySequence", [](const T* items, int n) -> Sequence<T>* { return new MutableArraySequence<T>(items, n); },
+            &visitStatic<MutableArraySequence<T>>},
+        {"ImmutableArraySequence", [](const T* items, int n) -> Sequence<T>* { return new ImmutableArraySequence<T>(items, n); },
+            &visitStatic<ImmutableArraySequence<T>>},
+        {"MutableListSequence", [](const T* items, int n) -> Sequence<T>* { return new MutableListSequence<T>(items, n); },
+            &visitStatic<MutableListSequence<T>>},
+        {"ImmutableListSequence", [](const T* items, int n) -> Sequence<T>* { return new ImmutableListSequence<T>(items, n); },
+            &visitStatic<ImmutableListSequence<T>>},
+        {"MutableSegmentedSequence", [segmentSize](const T* items, int n) -> Sequence<T>* {
+            return new MutableSegmentedSequence<T>(items, n, segmentSize);
+        }, &visitStatic<MutableSegmentedSequence<T>>},
+        {"ImmutableSegmentedSequence", [](const T* items, int n) -> Sequence<T>* { return new ImmutableSegmentedSequence<T>(items, n); },
+            &visitStatic<ImmutableSegmentedSequence<T>>},
+        {"MutableAdaptiveSequence", [](const T* items, int n) -> Sequence<T>* { return new MutableAdaptiveSequence<T>(items, n); },
+            &visitStatic<MutableAdaptiveSequence<T>>},
+        {"ImmutableAdaptiveSequence", [](const T* items, int n) -> Sequence<T>* { return new ImmutableAdaptiveSequence<T>(items, n); },
+            &visitStatic<ImmutableAdaptiveSequence<T>>},
+        {"MutableUnrolledListSequence", [](const T* items, int n) -> Sequence<T>* { return new MutableUnrolledListSequence<T>(items, n); },
+            &visitStatic<MutableUnrolledListSequence<T>>},
+        {"ImmutableUnrolledListSequence", [](const T* items, int n) -> Sequence<T>* { return new ImmutableUnrolledListSequence<T>(items, n); },
+            &visitStatic<ImmutableUnrolledListSequence<T>>},
+    };
+}
+
+
+class Reporter {
+private:
+    const Options& options;
+    bool first;
+
+public:
+    explicit Reporter(const Options& options_) : options(options_), first(true) {}
+
+    void Begin() {
+        if (options.format == "csv") {
+            std::cout << "sequence,type,operation,size,items,repetitions,best_ns_per_item,mean_ns_per_item";
+            if (SequenceStats::enabled) {
+                std::cout << ",allocations,bytes_allocated,copies,moves,clones,segment_splits,regrowths";
+            }
+            std::cout << "\n";
+        } else if (options.format == "json") {
+            char date[32];
+            std::time_t now = std::time(nullptr);
+            std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+            std::cout << "{\n  \"context\": {\"date\": \"" << date << "\", \"repetitions\": " << options.repetitions
+                      << ", \"max_ops\": " << options.maxOps << ", \"budget_ms\": " << options.budgetMs
+                      << "},\n  \"benchmarks\": [";
+        } else {
+            std::cout << std::left << std::setw(32) << "sequence" << std::setw(8) << "type" << std::setw(16) << "operation"
+                      << std::setw(10) << "size" << std::setw(10) << "items" << std::setw(14) << "best ns";
+            if (SequenceStats::enabled) {
+                std::cout << std::setw(14) << "mean ns" << std::setw(12) << "allocs" << std::setw(12) << "copies"
+                          << std::setw(12) << "moves" << "clones";
+            } else {
+                std::cout << "mean ns";
+            }
+            std::cout << "\n";
+        }
+    }
+
+    void Add(const Result& result) {
+        if (options.format == "csv") {
+            std::cout << result.sequence << "," << result.type << "," << result.operation << "," << result.size << ","
+                      << result.items << "," << result.repetitions << "," << result.bestNs << "," << result.meanNs;
+            if (SequenceStats::enabled) {
+                const SequenceStats& c = result.counters;
+                std::cout << "," << c.allocations << "," << c.bytesAllocated << "," << c.copies << "," << c.moves
+                          << "," << c.clones << "," << c.segmentSplits << "," << c.regrowths;
+            }
+            std::cout << "\n";
+        } else if (options.format == "json") {
+            std::cout << (first ? "\n" : ",\n") << "    {\"name\": \"" << result.sequence << "<" << result.type << ">/"
+                      << result.operation << "/" << result.size << "\", \"sequence\": \"" << result.sequence
+                      << "\", \"type\": \"" << result.type << "\", \"operation\": \"" << result.operation
+                      << "\", \"size\": " << result.size << ", \"items\": " << result.items
+                      << ", \"repetitions\": " << result.repetitions << ", \"best_ns_per_item\": " << result.bestNs
+                      << ", \"mean_ns_per_item\": " << result.meanNs;
+            if (SequenceStats::enabled) {
+                const SequenceStats& c = result.counters;
+                std::cout << ", \"counters\": {\"allocations\": " << c.allocations << ", \"bytes_allocated\": "
+                          << c.bytesAllocated << ", \"copies\": " << c.copies << ", \"moves\": " << c.moves
+                          << ", \"clones\": " << c.clones << ", \"segment_splits\": " << c.segmentSplits
+                          << ", \"regrowths\": " << c.regrowths << "}";
+            }
+            std::cout << "}";
+        } else {
+            std::cout << std::left << std::setw(32) << result.sequence << std::setw(8) << result.type
+                      << std::setw(16) << result.operation << std::setw(10) << result.size << std::setw(10) << result.items
+                      << std::setw(14) << result.bestNs;
+            if (SequenceStats::enabled) {
+                const SequenceStats& c = result.counters;
+                std::cout << std::setw(14) << result.meanNs << std::setw(12) << c.allocations << std::setw(12) << c.copies
+                          << std::setw(12) << c.moves << c.clones;
+            } else {
+                std::cout << result.meanNs;
+            }
+            std::cout << "\n";
+        }
+        std::cout.flush();
+        first = false;
+    }
+
+    void End() {
+        if (options.format == "json") {
+            std::cout << "\n  ]\n}\n";
+        }
+    }
+};
+
+
+template <typename T>
+class Runner {
+private:
+    using Clock = std::chrono::steady_clock;
+    using W = Workload<T>;
+
+    const Options& options;
+    Reporter& reporter;
+    const Implementation<T>& implementation;
+    std::string sequenceName;
+    Sequence<T>* base;
+    const std::vector<T>& items;
+    int size;
+
+    static double elapsedNs(Clock::time_point start) {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+
+    bool selected(const std::string& operation) const {
+        return ::selected(options, sequenceName, W::Name(), operation, size);
+    }
+
+    // Immutable operations hand back a new version each time; every version but the base and
+    // the newest one is dropped as soon as it is replaced.
+    Sequence<T>* advance(Sequence<T>* version, Sequence<T>* next) const {
+        if (version != base && version != next) {
+            delete version;
+        }
+        return next;
+    }
+
+    // `run` performs one repetition and returns the number of items it covered; `restore`
+    // (untimed) brings a mutable base back to its original contents afterwards.
+    template <typename Run, typename Restore>
+    void measure(const std::string& operation, Run run, Restore restore) {
+        if (!selected(operation)) {
+            return;
+        }
+
+        double best = 0;
+        double total = 0;
+        int items = 0;
+        SequenceStats counters;
+        for (int r = 0; r < options.repetitions; ++r) {
+            SequenceStats before = SequenceStats::Snapshot();
+            Clock::time_point start = Clock::now();
+            items = run();
+            double perItem = elapsedNs(start) / std::max(1, items);
+            counters = SequenceStats::Snapshot() - before;
+            restore(items);
+            best = r == 0 ? perItem : std::min(best, perItem);
+            total += perItem;
+        }
+        reporter.Add({sequenceName, W::Name(), operation, size, items, options.repetitions, best, total / options.repetitions,
+                      counters});
+    }
+
+    // Repeats op(i) up to maxOps times, stopping early once the time budget is spent.
+    template <typename Op>
+    int repeat(int maxOps, Op op) const {
+        Clock::time_point start = Clock::now();
+        int i = 0;
+        while (i < maxOps) {
+            op(i);
+            ++i;
+            if ((i & 15) == 0 && elapsedNs(start) > options.budgetMs * 1e6) {
+                break;
+            }
+        }
+        return i;
+    }
+
+    // Single-element updates leave the base alone when it is immutable and trim the added
+    // elements off again when it is mutable.
+    template <typename Update>
+    void measureUpdates(const std::string& operation, int maxOps, Update update, std::function<void(int)> trim) {
+        Sequence<T>* version = base;
+        measure(operation, [&] {
+            version = base;
+            return repeat(maxOps, [&](int i) {
+                version = advance(version, update(version, i));
+            });
+        }, [&](int done) {
+            if (version == base) {
+                trim(done);
+            } else {
+                delete version;
+            }
+        });
+    }
+
+public:
+    Runner(const Options& options_, Reporter& reporter_, const Implementation<T>& implementation_,
+           Sequence<T>* base_, const std::vector<T>& items_)
+        : options(options_), reporter(reporter_), implementation(implementation_), sequenceName(implementation_.name),
+          base(base_), items(items_), size(base_->GetLength()) {}
+
+    void Run() {
+        int updates = std::min(size, options.maxOps);
+        int middle = size / 2;
+
+        measureUpdates("Append", updates, [this](Sequence<T>* version, int i) {
+            return version->Append(items[i]);
+        }, [this](int done) { base->RemoveRange(size, size + done - 1); });
+
+        measureUpdates("Prepend", updates, [this](Sequence<T>* version, int i) {
+            return version->Prepend(items[i]);
+        }, [this](int done) { base->RemoveRange(0, done - 1); });
+
+        measureUpdates("InsertAt", updates, [this, middle](Sequence<T>* version, int i) {
+            return version->InsertAt(items[i], middle);
+        }, [this, middle](int done) { base->RemoveRange(middle, middle + done - 1); });
+
+        std::vector<int> positions(updates);
+        std::mt19937 random(12345);
+        for (int& position : positions) {
+            position = static_cast<int>(random() % static_cast<unsigned>(size));
+        }
+        measure("Get", [&] {
+            std::size_t digest = 0;
+            int done = repeat(updates, [&](int i) {
+                digest += W::Digest(base->Get(positions[i]));
+            });
+            sink = sink + digest;
+            return done;
+        }, [](int) {});
+
+        measure("ForEach", [&] {
+            std::size_t digest = 0;
+            base->ForEach([&digest](const T& item) {
+                digest += W::Digest(item);
+            });
+            sink = sink + digest;
+            return size;
+        }, [](int) {});
+
+        measure("Visit", [&] {
+            sink = sink + implementation.visit(*base);
+            return size;
+        }, [](int) {});
+
+        if (selected("Concat")) {
+            Sequence<T>* other = base->CreateSequence(items.data(), size);
+            Sequence<T>* result = nullptr;
+            measure("Concat", [&] {
+                result = base->Concat(other);
+                return size;
+            }, [&](int) {
+                if (result == base) {
+                    base->RemoveRange(size, 2 * size - 1);
+                } else {
+                    delete result;
+                }
+            });
+            delete other;
+        }
+
+        // The middle half, but never an empty window: size 1 still copies its one element.
+        int window = std::max(1, size / 2);
+        int windowStart = (size - window) / 2;
+        measure("GetSubsequence", [&] {
+            Sequence<T>* sub = base->GetSubsequence(windowStart, windowStart + window - 1);
+            int length = sub->GetLength();
+            delete sub;
+            return length;
+        }, [](int) {});
+
+        measure("Map", [&] {
+            Sequence<T>* mapped = base->Map(&W::Map);
+            delete mapped;
+            return size;
+        }, [](int) {});
+
+        measure("Where", [&] {
+            Sequence<T>* filtered = base->Where(&W::Keep);
+            sink = sink + filtered->GetLength();
+            delete filtered;
+            return size;
+        }, [](int) {});
+
+        measure("Reduce", [&] {
+            sink = sink + W::Digest(base->Reduce(&W::Combine, W::Make(0)));
+            return size;
+        }, [](int) {});
+    }
+};
+
+
+template <typename T>
+void benchmarkType(const Options& options, Reporter& reporter) {
+    using W = Workload<T>;
+    for (long long size = options.minSize; size <= options.maxSize; size *= 10) {
+        int n = static_cast<int>(size);
+        std::vector<T> items;
+        items.reserve(n);
+        for (int i = 0; i < n; ++i) {
+            items.push_back(W::Make(i));
+        }
+
+        for (const Implementation<T>& implementation : implementations<T>()) {
+            bool any = false;
+            for (const char* operation : operations) {
+                any = any || selected(options, implementation.name, W::Name(), operation, size);
+            }
+            if (!any) {
+                continue;
+            }
+
+            Sequence<T>* base = implementation.create(items.data(), n);
+            Runner<T>(options, reporter, implementation, base, items).Run();
+            delete base;
+        }
+    }
+}
+
+
+static bool readOption(const char* arg, const char* name, std::string& value) {
+    std::size_t length = std::strlen(name);
+    if (std::strncmp(arg, name, length) != 0 || arg[length] != '=') {
+        return false;
+    }
+    value = arg + length + 1;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string value;
+        if (readOption(argv[i], "--format", value)) {
+            options.format = value;
+        } else if (readOption(argv[i], "--min-size", value)) {
+            options.minSize = std::max(1LL, std::atoll(value.c_str()));
+        } else if (readOption(argv[i], "--max-size", value)) {
+            options.maxSize = std::atoll(value.c_str());
+        } else if (readOption(argv[i], "--repetitions", value)) {
+            options.repetitions = std::max(1, std::atoi(value.c_str()));
+        } else if (readOption(argv[i], "--max-ops", value)) {
+            options.maxOps = std::max(1, std::atoi(value.c_str()));
+        } else if (readOption(argv[i], "--budget-ms", value)) {
+            options.budgetMs = std::atof(value.c_str());
+        } else if (readOption(argv[i], "--filter", value)) {
+            options.filter = value;
+        } else {
+            std::cerr << "Unknown argument: " << argv[i] << "\n"
+                      << "Usage: " << argv[0] << " [--format=table|csv|json] [--min-size=N] [--max-size=N]"
+                      << " [--repetitions=N] [--max-ops=N] [--budget-ms=N] [--filter=TEXT]\n";
+            return 1;
+        }
+    }
+    if (options.format != "table" && options.format != "csv" && options.format != "json") {
+        std::cerr << "Unknown format: " << options.format << "\n";
+        return 1;
+    }
+
+    Reporter reporter(options);
+    reporter.Begin();
+    benchmarkType<int>(options, reporter);
+    benchmarkType<double>(options, reporter);
+    benchmarkType<std::string>(options, reporter);
+    reporter.End();
+    return 0;
+}
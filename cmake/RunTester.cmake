@@ -0,0 +1,20 @@
+# Runs the interactive tester for one element type and implementation and fails on any
+# [FAIL] line, or when no check ran at all.
+set(input "${CMAKE_CURRENT_BINARY_DIR}/tester_${TYPE}_${IMPLEMENTATION}.in")
+file(WRITE "${input}" "${TYPE}\n${IMPLEMENTATION}\n4\n")
+
+execute_process(COMMAND "${TESTER}"
+    INPUT_FILE "${input}"
+    OUTPUT_VARIABLE output
+    ERROR_VARIABLE errors
+    RESULT_VARIABLE result)
+
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Tester exited with ${result}\n${output}\n${errors}")
+endif()
+if(output MATCHES "\\[FAIL\\]")
+    message(FATAL_ERROR "Tester reported failures\n${output}")
+endif()
+if(NOT output MATCHES "\\[PASS\\]")
+    message(FATAL_ERROR "Tester ran no checks\n${output}")
+endif()
@@ -1,13 +1,24 @@
 #pragma once
+#include <iterator>
 #include "DynamicArray.hpp"
+#include "Instrumentation.hpp"
 #include "Sequence.hpp"
 
 template <typename T>
 class AdaptiveSequence : public Sequence<T> {
 private:
-    DynamicArray<T>* buffer;
+    using AllocatorTraits = std::allocator_traits<std::allocator<T>>;
+
+    // Below this many slots the buffer is never shrunk.
+    static const int minShrinkCapacity = 16;
+
+    // Circular buffer of capacity slots, always a power of two so positions wrap with a mask.
+    // The size live elements start at buffer[frontIndex] and may continue from buffer[0];
+    // every other slot is uninitialized. The buffer grows only when it is completely full.
+    std::allocator<T> allocator;
+    T* buffer;
+    int capacity;
     int frontIndex;
-    int backIndex;
     int size;
 
     int _getCapacity(int val) const {
@@ -17,149 +28,405 @@ private:
         return ret;
     }
 
-    void ensureCapacity() {
-        if (backIndex + 1 >= buffer->GetSize()) {
-            int newCapacity = buffer->GetSize() == 0 ? 1 : buffer->GetSize() * 2;
-            DynamicArray<T>* newBuffer = new DynamicArray<T>(newCapacity);
-            
-            int newFront = newCapacity / 4;
-            for (int i = 0; i < size; ++i) {
-                (*newBuffer)[newFront + i] = (*buffer)[frontIndex + i];
+    T* slot(int index) const {
+        return buffer + ((frontIndex + index) & (capacity - 1));
+    }
+
+    // Length of the run from frontIndex to the end of the buffer; the rest starts at buffer[0].
+    int firstRunLength() const {
+        return std::min(size, capacity - frontIndex);
+    }
+
+    void destroyRun(T* first, int count) {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (int i = 0; i < count; ++i) {
+                AllocatorTraits::destroy(allocator, first + i);
+            }
+        }
+    }
+
+    void destroyItems() {
+        int firstRun = firstRunLength();
+        destroyRun(buffer + frontIndex, firstRun);
+        destroyRun(buffer, size - firstRun);
+    }
+
+    void releaseBuffer() {
+        destroyItems();
+        if (buffer != nullptr) {
+            AllocatorTraits::deallocate(allocator, buffer, capacity);
+        }
+        buffer = nullptr;
+        capacity = 0;
+    }
+
+    // Constructs count slots at target from source, moving unless that could throw (a const
+    // source is always copied), and undoes the work if a constructor throws.
+    template <typename Source>
+    void constructRun(T* target, Source* source, int count) {
+        if constexpr (std::is_const_v<Source>) {
+            Instrument::Copies(count);
+        } else {
+            Instrument::Relocation<T>(count);
+        }
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (count > 0) {
+                std::memcpy(static_cast<void*>(target), static_cast<const void*>(source), sizeof(T) * count);
             }
-                        
-            delete buffer;
-            buffer = newBuffer;
-            frontIndex = newFront;
-            backIndex = newFront + size - 1;
-        }
-    }
-
-    void ensureFrontCapacity() {
-        if (frontIndex <= 0) {
-            int newCapacity = buffer->GetSize() == 0 ? 1 : buffer->GetSize() * 2;
-            DynamicArray<T>* newBuffer = new DynamicArray<T>(newCapacity);
-            
-            int newFront = newCapacity / 4;
-            for (int i = 0; i < size; ++i) {
-                (*newBuffer)[newFront + i] = (*buffer)[frontIndex + i];
+        } else {
+            int i = 0;
+            try {
+                for (; i < count; ++i) {
+                    AllocatorTraits::construct(allocator, target + i, std::move_if_noexcept(source[i]));
+                }
+            } catch (...) {
+                destroyRun(target, i);
+                throw;
+            }
+        }
+    }
+
+    // Unwraps the elements of source (this buffer, or another one to copy) to the start of
+    // a new buffer of newCapacity slots.
+    template <typename Source>
+    T* unwrapInto(int newCapacity, Source* sourceBuffer, int sourceFront, int firstRun, int count) {
+        Instrument::Allocation(static_cast<long long>(sizeof(T)) * newCapacity);
+        T* newBuffer = AllocatorTraits::allocate(allocator, newCapacity);
+        try {
+            constructRun(newBuffer, sourceBuffer + sourceFront, firstRun);
+            try {
+                constructRun(newBuffer + firstRun, sourceBuffer, count - firstRun);
+            } catch (...) {
+                destroyRun(newBuffer, firstRun);
+                throw;
             }
-            
-            delete buffer;
-            buffer = newBuffer;
-            frontIndex = newFront;
-            backIndex = newFront + size - 1;
+        } catch (...) {
+            AllocatorTraits::deallocate(allocator, newBuffer, newCapacity);
+            throw;
         }
+        return newBuffer;
+    }
+
+    void relocate(int newCapacity) {
+        T* newBuffer = unwrapInto(newCapacity, buffer, frontIndex, firstRunLength(), size);
+        if constexpr (!std::is_trivially_copyable_v<T>) {
+            destroyItems();
+        }
+        if (buffer != nullptr) {
+            AllocatorTraits::deallocate(allocator, buffer, capacity);
+        }
+        buffer = newBuffer;
+        capacity = newCapacity;
+        frontIndex = 0;
+    }
+
+    bool isFull() const {
+        return size == capacity;
+    }
+
+    void grow() {
+        Instrument::Regrowth();
+        relocate(capacity == 0 ? 1 : capacity * 2);
+    }
+
+    // Halves the buffer while at most a quarter of it is used, so it stays at least half
+    // full afterwards and a following burst of appends does not immediately regrow it.
+    void shrinkIfSparse() {
+        int newCapacity = capacity;
+        while (newCapacity > minShrinkCapacity && size * 4 <= newCapacity) {
+            newCapacity /= 2;
+        }
+        if (newCapacity != capacity) {
+            relocate(newCapacity);
+        }
+    }
+
+    void copyFrom(const AdaptiveSequence& other) {
+        int newCapacity = _getCapacity(other.size);
+        buffer = newCapacity == 0 ? nullptr
+                                  : unwrapInto(newCapacity, static_cast<const T*>(other.buffer), other.frontIndex,
+                                               other.firstRunLength(), other.size);
+        capacity = newCapacity;
+        frontIndex = 0;
+        size = other.size;
     }
 
     virtual AdaptiveSequence<T>* Instance() = 0;
     virtual AdaptiveSequence<T>* CreateEmptyAdaptiveSequence() const = 0;
 
 public:
-    AdaptiveSequence() : buffer(new DynamicArray<T>()), frontIndex(0), backIndex(-1), size(0) {}
+    AdaptiveSequence() : buffer(nullptr), capacity(0), frontIndex(0), size(0) {}
 
     AdaptiveSequence(const T* items, int count) 
-        : buffer(new DynamicArray<T>(_getCapacity(count))), frontIndex(0), backIndex(count-1), size(count) {
-        for (int i = 0; i < count; ++i) {
-            (*buffer)[i] = items[i];
+        : buffer(nullptr), capacity(0), frontIndex(0), size(0) {
+        if (count > 0) {
+            int newCapacity = _getCapacity(count);
+            buffer = unwrapInto(newCapacity, items, 0, count, count);
+            capacity = newCapacity;
+            size = count;
         }
     }
 
-    AdaptiveSequence(const AdaptiveSequence& other) 
-        : buffer(new DynamicArray<T>(*other.buffer)), 
-          frontIndex(other.frontIndex), 
-          backIndex(other.backIndex), 
-          size(other.size) {}
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    AdaptiveSequence(InputIterator first, InputIterator last) : AdaptiveSequence() {
+        if constexpr (IsForwardIterator<InputIterator>::value) {
+            Reserve(static_cast<int>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            appendItem(*first);
+        }
+    }
+
+    AdaptiveSequence(std::initializer_list<T> items) : AdaptiveSequence(items.begin(), static_cast<int>(items.size())) {}
+
+    AdaptiveSequence(const AdaptiveSequence& other) : Sequence<T>() {
+        copyFrom(other);
+    }
 
     AdaptiveSequence(AdaptiveSequence&& other) noexcept 
         : buffer(other.buffer), 
+          capacity(other.capacity),
           frontIndex(other.frontIndex), 
-          backIndex(other.backIndex), 
           size(other.size) {
         other.buffer = nullptr;
+        other.capacity = 0;
+        other.frontIndex = 0;
+        other.size = 0;
     }
 
     ~AdaptiveSequence() override {
-        delete buffer;
+        releaseBuffer();
     }
 
     AdaptiveSequence& operator=(const AdaptiveSequence& other) {
         if (this != &other) {
-            delete buffer;
-            buffer = new DynamicArray<T>(*other.buffer);
-            frontIndex = other.frontIndex;
-            backIndex = other.backIndex;
-            size = other.size;
+            releaseBuffer();
+            frontIndex = 0;
+            size = 0;
+            copyFrom(other);
         }
         return *this;
     }
 
     AdaptiveSequence& operator=(AdaptiveSequence&& other) noexcept {
         if (this != &other) {
-            delete buffer;
+            releaseBuffer();
             buffer = other.buffer;
+            capacity = other.capacity;
             frontIndex = other.frontIndex;
-            backIndex = other.backIndex;
             size = other.size;
             other.buffer = nullptr;
+            other.capacity = 0;
+            other.frontIndex = 0;
+            other.size = 0;
         }
         return *this;
     }
     virtual Sequence<T>* CreateEmptySequence() const override {
         return CreateEmptyAdaptiveSequence();
     }
-    virtual Sequence<T>* AppendInternal(const T& item) override {
-        ensureCapacity();
-        if (size == 0) {
-            frontIndex = backIndex = buffer->GetSize() == 0 ? 0 : buffer->GetSize() / 2;
+
+    int GetCapacity() const {
+        return capacity;
+    }
+
+    // Makes room for newCapacity elements in total, rounded up to a power of two.
+    void Reserve(int newCapacity) {
+        if (newCapacity > capacity) {
+            relocate(_getCapacity(newCapacity));
+        }
+    }
+
+    // Shrinks the buffer to the smallest power of two that holds every element.
+    void ShrinkToFit() {
+        int newCapacity = _getCapacity(size);
+        if (newCapacity != capacity) {
+            relocate(newCapacity);
+        }
+    }
+
+private:
+    // When the buffer is full the item is taken out before it grows, since it may refer into it.
+    template <typename U>
+    Sequence<T>* appendItem(U&& item) {
+        Instrument::Construction<T, U>();
+        if (isFull()) {
+            T value(std::forward<U>(item));
+            grow();
+            AllocatorTraits::construct(allocator, slot(size), std::move(value));
         } else {
-            if (backIndex + 1 >= buffer->GetSize()) ensureCapacity();
-            backIndex++;
+            AllocatorTraits::construct(allocator, slot(size), std::forward<U>(item));
         }
-        (*buffer)[backIndex] = item;
         size++;
         return this;
     }
 
-    virtual Sequence<T>* PrependInternal(const T& item) override {
-        ensureFrontCapacity();
-        if (size == 0) {
-            frontIndex = backIndex = buffer->GetSize() == 0 ? 0 : buffer->GetSize() / 2;
+    template <typename U>
+    Sequence<T>* prependItem(U&& item) {
+        Instrument::Construction<T, U>();
+        if (isFull()) {
+            T value(std::forward<U>(item));
+            grow();
+            AllocatorTraits::construct(allocator, slot(capacity - 1), std::move(value));
         } else {
-            if (frontIndex - 1 < 0) ensureFrontCapacity();
-            frontIndex--;
+            AllocatorTraits::construct(allocator, slot(capacity - 1), std::forward<U>(item));
         }
-        (*buffer)[frontIndex] = item;
+        frontIndex = (frontIndex - 1) & (capacity - 1);
         size++;
         return this;
     }
 
-    virtual Sequence<T>* InsertAtInternal(const T& item, int index) override {
+    // Move-assigns count live elements from position from to position to, one piece that is
+    // contiguous at both ends at a time. Pieces are taken in the direction of the move, so
+    // overlapping ranges are safe.
+    void shiftItems(int from, int to, int count) {
+        Instrument::Moves(count);
+        int mask = capacity - 1;
+        if (to < from) {
+            while (count > 0) {
+                int source = (frontIndex + from) & mask;
+                int target = (frontIndex + to) & mask;
+                int length = std::min({count, capacity - source, capacity - target});
+                std::move(buffer + source, buffer + source + length, buffer + target);
+                from += length;
+                to += length;
+                count -= length;
+            }
+        } else {
+            while (count > 0) {
+                int sourceEnd = ((frontIndex + from + count - 1) & mask) + 1;
+                int targetEnd = ((frontIndex + to + count - 1) & mask) + 1;
+                int length = std::min({count, sourceEnd, targetEnd});
+                std::move_backward(buffer + sourceEnd - length, buffer + sourceEnd, buffer + targetEnd);
+                count -= length;
+            }
+        }
+    }
+
+    // Opens a slot at index by moving the shorter side one step outwards. The item is taken
+    // out first, since it may refer to an element that is about to move.
+    template <typename U>
+    Sequence<T>* insertItem(U&& item, int index) {
         if (index < 0 || index > size) throw std::out_of_range("Index out of range");
         
-        if (index == 0) return PrependInternal(item);
-        if (index == size) return AppendInternal(item);
+        if (index == 0) return prependItem(std::forward<U>(item));
+        if (index == size) return appendItem(std::forward<U>(item));
         
-        Sequence<T>* newSeq = CreateEmptySequence();
-        for (int i = 0; i < index; ++i) {
-            newSeq->AppendInternal((*this)[i]);
+        Instrument::Construction<T, U>();
+        Instrument::Moves(1);
+        T value(std::forward<U>(item));
+        if (isFull()) grow();
+
+        if (index < size - index) {
+            AllocatorTraits::construct(allocator, slot(capacity - 1), std::move(*slot(0)));
+            frontIndex = (frontIndex - 1) & (capacity - 1);
+            size++;
+            shiftItems(2, 1, index - 1);
+        } else {
+            AllocatorTraits::construct(allocator, slot(size), std::move(*slot(size - 1)));
+            size++;
+            shiftItems(index, index + 1, size - 2 - index);
         }
-        newSeq->AppendInternal(item);
-        for (int i = index; i < size; ++i) {
-            newSeq->AppendInternal((*this)[i]);
+        *slot(index) = std::move(value);
+        return this;
+    }
+
+    // Copies count items behind the last element; the room must already be reserved.
+    void appendRun(const T* items, int count) {
+        int tail = (frontIndex + size) & (capacity - 1);
+        int firstRun = std::min(count, capacity - tail);
+        constructRun(buffer + tail, items, firstRun);
+        size += firstRun;
+        constructRun(slot(size), items + firstRun, count - firstRun);
+        size += count - firstRun;
+    }
+
+    // Closes the gap [startIndex, endIndex] from whichever side has fewer elements, so
+    // removing at either end costs O(1).
+    void removeRange(int startIndex, int endIndex) {
+        int count = endIndex - startIndex + 1;
+        if (startIndex < size - 1 - endIndex) {
+            shiftItems(0, count, startIndex);
+            for (int i = 0; i < count; ++i) {
+                AllocatorTraits::destroy(allocator, slot(i));
+            }
+            frontIndex = (frontIndex + count) & (capacity - 1);
+        } else {
+            shiftItems(endIndex + 1, startIndex, size - endIndex - 1);
+            for (int i = size - count; i < size; ++i) {
+                AllocatorTraits::destroy(allocator, slot(i));
+            }
         }
-        
-        return newSeq;
+        size -= count;
+        shrinkIfSparse();
+    }
+
+public:
+    virtual Sequence<T>* AppendInternal(const T& item) override {
+        return appendItem(item);
+    }
+
+    virtual Sequence<T>* AppendInternal(T&& item) override {
+        return appendItem(std::move(item));
+    }
+
+    virtual Sequence<T>* PrependInternal(const T& item) override {
+        return prependItem(item);
+    }
+
+    virtual Sequence<T>* PrependInternal(T&& item) override {
+        return prependItem(std::move(item));
+    }
+
+    virtual Sequence<T>* InsertAtInternal(const T& item, int index) override {
+        return insertItem(item, index);
+    }
+
+    virtual Sequence<T>* InsertAtInternal(T&& item, int index) override {
+        return insertItem(std::move(item), index);
     }
 
+    // Reserves once and copies other run by run. Only the elements other had on entry are
+    // read, so concatenating a sequence with itself works.
     virtual Sequence<T>* ConcatInternal(const Sequence<T>* other) override {
-        Sequence<T>* newSeq = CreateEmptySequence();
-        for (int i = 0; i < this->GetLength(); ++i) {
-            newSeq->AppendInternal((*this)[i]);
+        int left = other->GetLength();
+        Reserve(size + left);
+        other->ForEachChunk([this, &left](const T* chunk, int length) {
+            int count = std::min(length, left);
+            appendRun(chunk, count);
+            left -= count;
+            return left > 0;
+        });
+        return this;
+    }
+
+    virtual Sequence<T>* RemoveAtInternal(int index) override {
+        removeRange(index, index);
+        return this;
+    }
+
+    virtual Sequence<T>* RemoveRangeInternal(int startIndex, int endIndex) override {
+        removeRange(startIndex, endIndex);
+        return this;
+    }
+
+    virtual Sequence<T>* RemoveIfInternal(const std::function<bool(const T&)>& predicate) override {
+        int kept = 0;
+        for (int i = 0; i < size; ++i) {
+            if (!predicate(*slot(i))) {
+                if (kept != i) {
+                    Instrument::Moves(1);
+                    *slot(kept) = std::move(*slot(i));
+                }
+                ++kept;
+            }
         }
-        for (int i = 0; i < other->GetLength(); ++i) {
-            newSeq->AppendInternal(other->Get(i));
+        for (int i = kept; i < size; ++i) {
+            AllocatorTraits::destroy(allocator, slot(i));
         }
-        return newSeq;
+        size = kept;
+        shrinkIfSparse();
+        return this;
     }
 
     int GetLength() const override {
@@ -168,89 +435,213 @@ public:
 
     const T& GetFirst() const override {
         if (size == 0) throw std::out_of_range("Sequence is empty");
-        return (*buffer)[frontIndex];
+        return buffer[frontIndex];
     }
 
     const T& GetLast() const override {
         if (size == 0) throw std::out_of_range("Sequence is empty");
-        return (*buffer)[backIndex];
+        return *slot(size - 1);
     }
 
     const T& Get(int index) const override {
         if (index < 0 || index >= size) throw std::out_of_range("Index out of range");
-        return (*buffer)[frontIndex + index];
+        return *slot(index);
+    }
+
+    const T& GetUnchecked(int index) const override {
+        return *slot(index);
     }
 
     T& GetFirst() override {
         if (size == 0) throw std::out_of_range("Sequence is empty");
-        return (*buffer)[frontIndex];
+        return buffer[frontIndex];
     }
 
     T& GetLast() override {
         if (size == 0) throw std::out_of_range("Sequence is empty");
-        return (*buffer)[backIndex];
+        return *slot(size - 1);
     }
 
     T& Get(int index) override {
         if (index < 0 || index >= size) throw std::out_of_range("Index out of range");
-        return (*buffer)[frontIndex + index];
+        return *slot(index);
+    }
+
+    T& GetUnchecked(int index) override {
+        return *slot(index);
     }
 
     Sequence<T>* Append(const T& item) override {
         return Instance()->AppendInternal(item);
     }
 
+    Sequence<T>* Append(T&& item) override {
+        return Instance()->AppendInternal(std::move(item));
+    }
+
     Sequence<T>* Prepend(const T& item) override {
         return Instance()->PrependInternal(item);
     }
 
+    Sequence<T>* Prepend(T&& item) override {
+        return Instance()->PrependInternal(std::move(item));
+    }
+
     Sequence<T>* InsertAt(const T& item, int index) override {
         if (index < 0 || index > size) throw std::out_of_range("Index out of range");
         return Instance()->InsertAtInternal(item, index);
     }
 
+    Sequence<T>* InsertAt(T&& item, int index) override {
+        if (index < 0 || index > size) throw std::out_of_range("Index out of range");
+        return Instance()->InsertAtInternal(std::move(item), index);
+    }
+
     Sequence<T>* Concat(const Sequence<T>* other) override {
         return Instance()->ConcatInternal(other);
     }
 
+    Sequence<T>* RemoveAt(int index) override {
+        if (index < 0 || index >= size) throw std::out_of_range("Index out of range");
+        return Instance()->RemoveAtInternal(index);
+    }
+
+    Sequence<T>* RemoveRange(int startIndex, int endIndex) override {
+        if (std::min(startIndex, endIndex) < 0 || std::max(startIndex, endIndex) >= size) {
+            throw std::out_of_range("Invalid index range");
+        }
+        return Instance()->RemoveRangeInternal(std::min(startIndex, endIndex), std::max(startIndex, endIndex));
+    }
+
+    Sequence<T>* RemoveIf(const std::function<bool(const T&)>& predicate) override {
+        return Instance()->RemoveIfInternal(predicate);
+    }
+
     T& operator[](int index) override {
         return Get(index);
     }
 
     Sequence<T>* GetSubsequence(int startIndex, int endIndex) const override {
-        if (size == 0 || startIndex < 0 || endIndex >= size || startIndex > endIndex) {
+        if (std::min(startIndex, endIndex) < 0 || std::max(startIndex, endIndex) >= size) {
             throw std::out_of_range("Invalid index range");
         }
         
         AdaptiveSequence<T>* subSeq = CreateEmptyAdaptiveSequence();
-        for (int i = startIndex; i <= endIndex; ++i) {
-            subSeq->AppendInternal(this->Get(i));
+        subSeq->Reserve(std::max(startIndex, endIndex) - std::min(startIndex, endIndex) + 1);
+        int step = startIndex <= endIndex ? 1 : -1;
+        for (int i = startIndex; i != endIndex + step; i += step) {
+            subSeq->AppendInternal(*slot(i));
         }
         return subSeq;
     }
 
-    class Iterator {
+    // Random-access iterator that maps positions through the ring.
+    template <bool IsConst>
+    class RingIterator {
     private:
-        AdaptiveSequence<T>* sequence;
+        using Owner = std::conditional_t<IsConst, const AdaptiveSequence<T>, AdaptiveSequence<T>>;
+
+        Owner* owner;
         int index;
-    
+
     public:
-        Iterator(AdaptiveSequence<T>* seq, int ind) : sequence(seq), index(ind) {}
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+
+        RingIterator() : owner(nullptr), index(0) {}
+        RingIterator(Owner* owner_, int index_) : owner(owner_), index(index_) {}
+
+        reference operator*() const {
+            return *owner->slot(index);
+        }
+
+        pointer operator->() const {
+            return owner->slot(index);
+        }
 
-        T& operator*() {
-            return sequence->Get(index);
+        reference operator[](difference_type offset) const {
+            return *owner->slot(index + static_cast<int>(offset));
         }
 
-        Iterator& operator++() {
+        RingIterator& operator++() {
             ++index;
             return *this;
         }
 
-        bool operator!=(const Iterator& other) const {
+        RingIterator operator++(int) {
+            RingIterator ret = *this;
+            ++index;
+            return ret;
+        }
+
+        RingIterator& operator--() {
+            --index;
+            return *this;
+        }
+
+        RingIterator operator--(int) {
+            RingIterator ret = *this;
+            --index;
+            return ret;
+        }
+
+        RingIterator& operator+=(difference_type offset) {
+            index += static_cast<int>(offset);
+            return *this;
+        }
+
+        RingIterator& operator-=(difference_type offset) {
+            index -= static_cast<int>(offset);
+            return *this;
+        }
+
+        RingIterator operator+(difference_type offset) const {
+            return RingIterator(owner, index + static_cast<int>(offset));
+        }
+
+        friend RingIterator operator+(difference_type offset, const RingIterator& it) {
+            return it + offset;
+        }
+
+        RingIterator operator-(difference_type offset) const {
+            return RingIterator(owner, index - static_cast<int>(offset));
+        }
+
+        difference_type operator-(const RingIterator& other) const {
+            return index - other.index;
+        }
+
+        bool operator==(const RingIterator& other) const {
+            return index == other.index;
+        }
+
+        bool operator!=(const RingIterator& other) const {
             return index != other.index;
         }
+
+        bool operator<(const RingIterator& other) const {
+            return index < other.index;
+        }
+
+        bool operator>(const RingIterator& other) const {
+            return index > other.index;
+        }
+
+        bool operator<=(const RingIterator& other) const {
+            return index <= other.index;
+        }
+
+        bool operator>=(const RingIterator& other) const {
+            return index >= other.index;
+        }
     };
 
+    using Iterator = RingIterator<false>;
+    using ConstIterator = RingIterator<true>;
+
     Iterator begin() {
         return Iterator(this, 0);
     }
@@ -258,16 +649,41 @@ public:
     Iterator end() {
         return Iterator(this, size);
     }
+
+    ConstIterator begin() const {
+        return ConstIterator(this, 0);
+    }
+
+    ConstIterator end() const {
+        return ConstIterator(this, size);
+    }
+
+    // The elements form one run, or two when they wrap past the end of the buffer.
+    template <typename Visitor>
+    bool VisitChunks(Visitor&& visitor) const {
+        int firstRun = firstRunLength();
+        if (firstRun > 0 && !visitor(static_cast<const T*>(buffer + frontIndex), firstRun)) {
+            return false;
+        }
+        return size == firstRun || visitor(static_cast<const T*>(buffer), size - firstRun);
+    }
+
+    bool ForEachChunk(const std::function<bool(const T*, int)>& visitor) const override {
+        return VisitChunks(visitor);
+    }
 };
 
 
 template <typename T>
-class MutableAdaptiveSequence : public AdaptiveSequence<T> {
+class MutableAdaptiveSequence final : public AdaptiveSequence<T>, public StaticSequence<MutableAdaptiveSequence<T>, T> {
 public:
     using tag = MutableSequenceTag;
 
     MutableAdaptiveSequence() : AdaptiveSequence<T>() {}
     MutableAdaptiveSequence(const T* items, int count) : AdaptiveSequence<T>(items, count) {}
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    MutableAdaptiveSequence(InputIterator first, InputIterator last) : AdaptiveSequence<T>(first, last) {}
+    MutableAdaptiveSequence(std::initializer_list<T> items) : AdaptiveSequence<T>(items) {}
     MutableAdaptiveSequence(const AdaptiveSequence<T>& other) : AdaptiveSequence<T>(other) {}
     MutableAdaptiveSequence(AdaptiveSequence<T>&& other) : AdaptiveSequence<T>(std::move(other)) {}
 
@@ -284,31 +700,41 @@ public:
     virtual Sequence<T>* CreateEmptySequence() const override {
         return new MutableAdaptiveSequence<T>();
     }
+
+    virtual Sequence<T>* CreateSequence(const T* items, int count) const override {
+        return new MutableAdaptiveSequence<T>(items, count);
+    }
 };
 
 
+// Another name for the shared persistent vector (see PersistentSequence): its layout does
+// not adapt to the access pattern.
 template <typename T>
-class ImmutableAdaptiveSequence : public AdaptiveSequence<T> {
+class ImmutableAdaptiveSequence final : public PersistentSequence<T>, public StaticSequence<ImmutableAdaptiveSequence<T>, T> {
 private:
-    AdaptiveSequence<T>* Clone() const {
+    PersistentSequence<T>* Clone() const {
+        Instrument::Clone();
         return new ImmutableAdaptiveSequence<T>(*this);
     }
 
 public:
     using tag = ImmutableSequenceTag;
 
-    ImmutableAdaptiveSequence() : AdaptiveSequence<T>() {}
-    ImmutableAdaptiveSequence(const T* items, int count) : AdaptiveSequence<T>(items, count) {}
-    ImmutableAdaptiveSequence(const Sequence<T>& other) : AdaptiveSequence<T>(other) {}
-    ImmutableAdaptiveSequence(AdaptiveSequence<T>&& other) : AdaptiveSequence<T>(std::move(other)) {}
-    ImmutableAdaptiveSequence(const ImmutableAdaptiveSequence<T>& other) : AdaptiveSequence<T>(other) {}
+    ImmutableAdaptiveSequence() : PersistentSequence<T>() {}
+    ImmutableAdaptiveSequence(const T* items, int count) : PersistentSequence<T>(items, count) {}
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    ImmutableAdaptiveSequence(InputIterator first, InputIterator last) : PersistentSequence<T>(first, last) {}
+    ImmutableAdaptiveSequence(std::initializer_list<T> items) : PersistentSequence<T>(items) {}
+    ImmutableAdaptiveSequence(const Sequence<T>& other) : PersistentSequence<T>(other) {}
+    ImmutableAdaptiveSequence(const ImmutableAdaptiveSequence<T>& other) : PersistentSequence<T>(other) {}
+    ImmutableAdaptiveSequence(ImmutableAdaptiveSequence<T>&& other) noexcept : PersistentSequence<T>(std::move(other)) {}
 
 protected:
-    virtual AdaptiveSequence<T>* Instance() override {
+    virtual PersistentSequence<T>* Instance() override {
         return Clone();
     }
     
-    virtual AdaptiveSequence<T>* CreateEmptyAdaptiveSequence() const override {
+    virtual PersistentSequence<T>* CreateEmptyPersistentSequence() const override {
         return new ImmutableAdaptiveSequence<T>();
     }
 
@@ -316,4 +742,8 @@ public:
     virtual Sequence<T>* CreateEmptySequence() const override {
         return new ImmutableAdaptiveSequence<T>();
     }
+
+    virtual Sequence<T>* CreateSequence(const T* items, int count) const override {
+        return new ImmutableAdaptiveSequence<T>(items, count);
+    }
 };
\ No newline at end of file
@@ -2,11 +2,24 @@
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
+#include <memory>
+#include <utility>
+#include <cstring>
+#include <type_traits>
+#include "IteratorTraits.hpp"
+#include "Instrumentation.hpp"
 
 
-template <typename T>
+// Elements live in raw storage from Allocator: only the window [data, data + size) holds
+// constructed objects, the slots before and after it stay uninitialized. The headroom in
+// front makes EmplaceFront amortized O(1), and EmplaceAt shifts only the shorter side.
+template <typename T, typename Allocator = std::allocator<T>>
 class DynamicArray {
 private:
+    using AllocatorTraits = std::allocator_traits<Allocator>;
+
+    Allocator allocator;
+    T* storage;
     T* data;
     int size;
     int capacity;
@@ -26,25 +39,228 @@ private:
         }
     }
 
+    int _frontRoom() const {
+        return static_cast<int>(data - storage);
+    }
+
+    int _backRoom() const {
+        return capacity - _frontRoom() - size;
+    }
+
+    T* _allocate(int count) {
+        if (count == 0) {
+            return nullptr;
+        }
+        Instrument::Allocation(static_cast<long long>(sizeof(T)) * count);
+        return AllocatorTraits::allocate(allocator, count);
+    }
+
+    void _deallocate(T* block, int count) {
+        if (block != nullptr) {
+            AllocatorTraits::deallocate(allocator, block, count);
+        }
+    }
+
+    void _destroy(T* first, T* last) {
+        for (; first != last; ++first) {
+            AllocatorTraits::destroy(allocator, first);
+        }
+    }
+
+    // Constructs [0, count) of `target` from `make(i)`, undoing the work if one throws.
+    template <typename Make>
+    void _constructAll(T* target, int count, Make make) {
+        int i = 0;
+        try {
+            for (; i < count; ++i) {
+                AllocatorTraits::construct(allocator, target + i, make(i));
+            }
+        } catch (...) {
+            _destroy(target, target + i);
+            throw;
+        }
+    }
+
+    // Moves the live elements into a fresh block of newCapacity slots, starting at offset.
+    void _reallocate(int newCapacity, int offset) {
+        T* newStorage = _allocate(newCapacity);
+        if (newCapacity > capacity) {
+            Instrument::Regrowth();
+        }
+        Instrument::Relocation<T>(size);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (size > 0) {
+                std::memcpy(static_cast<void*>(newStorage + offset), static_cast<const void*>(data), sizeof(T) * size);
+            }
+        } else {
+            try {
+                _constructAll(newStorage + offset, size, [this](int i) -> decltype(auto) {
+                    return std::move_if_noexcept(data[i]);
+                });
+            } catch (...) {
+                _deallocate(newStorage, newCapacity);
+                throw;
+            }
+            _destroy(data, data + size);
+        }
+
+        _deallocate(storage, capacity);
+        storage = newStorage;
+        data = newStorage + offset;
+        capacity = newCapacity;
+    }
+
+    // Called when the front (or back) has no free slot. A block that is at most half full
+    // is recentred; otherwise it doubles and the side that ran out gets all the new room.
+    void _makeRoom(bool atFront) {
+        int free = capacity - size;
+        if (size + 1 <= capacity / 2) {
+            _reallocate(capacity, free / 2);
+        } else {
+            int newCapacity = capacity == 0 ? 1 : capacity * 2;
+            _reallocate(newCapacity, atFront ? newCapacity - size - _backRoom() : _frontRoom());
+        }
+    }
+
+    void _release() {
+        _destroy(data, data + size);
+        _deallocate(storage, capacity);
+        storage = nullptr;
+        data = nullptr;
+        size = 0;
+        capacity = 0;
+    }
+
+    // Opens a slot at `index` by moving [0, index) one step left, then fills it.
+    void _insertShiftingFront(T&& value, int index) {
+        Instrument::Moves(index);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::memmove(static_cast<void*>(data - 1), static_cast<const void*>(data), sizeof(T) * index);
+            --data;
+            AllocatorTraits::construct(allocator, data + index, std::move(value));
+        } else {
+            AllocatorTraits::construct(allocator, data - 1, std::move(data[0]));
+            --data;
+            std::move(data + 2, data + index + 1, data + 1);
+            data[index] = std::move(value);
+        }
+        ++size;
+    }
+
+    // Opens a slot at `index` by moving [index, size) one step right, then fills it.
+    void _insertShiftingBack(T&& value, int index) {
+        Instrument::Moves(size - index);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::memmove(static_cast<void*>(data + index + 1), static_cast<const void*>(data + index), sizeof(T) * (size - index));
+            AllocatorTraits::construct(allocator, data + index, std::move(value));
+        } else {
+            AllocatorTraits::construct(allocator, data + size, std::move(data[size - 1]));
+            std::move_backward(data + index, data + size - 1, data + size);
+            data[index] = std::move(value);
+        }
+        ++size;
+    }
+
 public:
-    DynamicArray(): data(nullptr), size(0), capacity(0) {}
+    using Iterator = T*;
+    using ConstIterator = const T*;
 
-    DynamicArray(int initialCapacity) : size(initialCapacity), capacity(_getCapacity(initialCapacity)) {
-        data = new T[capacity];
+    DynamicArray(): allocator(), storage(nullptr), data(nullptr), size(0), capacity(0) {}
+
+    explicit DynamicArray(const Allocator& allocator_)
+        : allocator(allocator_), storage(nullptr), data(nullptr), size(0), capacity(0) {}
+
+    DynamicArray(int initialCapacity, const Allocator& allocator_ = Allocator())
+        : allocator(allocator_), storage(nullptr), data(nullptr), size(0), capacity(_getCapacity(initialCapacity)) {
+        storage = data = _allocate(capacity);
+        try {
+            _constructAll(data, initialCapacity, [](int) { return T(); });
+        } catch (...) {
+            _deallocate(storage, capacity);
+            throw;
+        }
+        size = initialCapacity;
     }
 
-    DynamicArray(const T* items, int count) : size(count), capacity(_getCapacity(count)) {
-        data = new T[capacity];
-        std::copy(items, items + count, data);
+    DynamicArray(const T* items, int count, const Allocator& allocator_ = Allocator())
+        : allocator(allocator_), storage(nullptr), data(nullptr), size(0), capacity(_getCapacity(count)) {
+        storage = data = _allocate(capacity);
+        try {
+            Instrument::Copies(count);
+            _constructAll(data, count, [items](int i) -> const T& { return items[i]; });
+        } catch (...) {
+            _deallocate(storage, capacity);
+            throw;
+        }
+        size = count;
+    }
+
+    // Sizes the block once when the range can be measured, then copies with its own iterator.
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    DynamicArray(InputIterator first, InputIterator last, const Allocator& allocator_ = Allocator())
+        : DynamicArray(allocator_) {
+        if constexpr (IsForwardIterator<InputIterator>::value) {
+            Reserve(static_cast<int>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            EmplaceBack(*first);
+        }
+    }
+
+    DynamicArray(const DynamicArray& other)
+        : allocator(AllocatorTraits::select_on_container_copy_construction(other.allocator)),
+          storage(nullptr), data(nullptr), size(0), capacity(other.capacity) {
+        storage = _allocate(capacity);
+        data = storage + other._frontRoom();
+        try {
+            Instrument::Copies(other.size);
+            _constructAll(data, other.size, [&other](int i) -> const T& { return other.data[i]; });
+        } catch (...) {
+            _deallocate(storage, capacity);
+            throw;
+        }
+        size = other.size;
     }
 
-    DynamicArray(const DynamicArray& other) : size(other.size), capacity(other.capacity) {
-        data = new T[capacity];
-        std::copy(other.data, other.data + size, data);
+    DynamicArray(DynamicArray&& other) noexcept
+        : allocator(std::move(other.allocator)), storage(other.storage), data(other.data),
+          size(other.size), capacity(other.capacity) {
+        other.storage = nullptr;
+        other.data = nullptr;
+        other.size = 0;
+        other.capacity = 0;
     }
 
     ~DynamicArray() {
-        delete[] data;
+        _release();
+    }
+
+    DynamicArray& operator=(const DynamicArray& other) {
+        if (this != &other) {
+            DynamicArray copy(other);
+            std::swap(storage, copy.storage);
+            std::swap(data, copy.data);
+            std::swap(size, copy.size);
+            std::swap(capacity, copy.capacity);
+            std::swap(allocator, copy.allocator);
+        }
+        return *this;
+    }
+
+    DynamicArray& operator=(DynamicArray&& other) noexcept {
+        if (this != &other) {
+            _release();
+            allocator = std::move(other.allocator);
+            storage = other.storage;
+            data = other.data;
+            size = other.size;
+            capacity = other.capacity;
+            other.storage = nullptr;
+            other.data = nullptr;
+            other.size = 0;
+            other.capacity = 0;
+        }
+        return *this;
     }
 
     T& operator[](int index) {
@@ -57,18 +273,61 @@ public:
         return size;
     }
 
+    int GetCapacity() const {
+        return capacity;
+    }
+
+    Iterator begin() {
+        return data;
+    }
+
+    Iterator end() {
+        return data + size;
+    }
+
+    ConstIterator begin() const {
+        return data;
+    }
+
+    ConstIterator end() const {
+        return data + size;
+    }
+
+    // Makes room for newCapacity elements counted from the first live one.
+    void Reserve(int newCapacity) {
+        if (newCapacity > capacity - _frontRoom()) {
+            _reallocate(_frontRoom() + newCapacity, _frontRoom());
+        }
+    }
+
+    // Turns the count reserved slots from end() on, which the caller has constructed
+    // itself (for example from several threads after one Reserve), into live elements.
+    void Adopt(int count) {
+        if (count < 0 || count > _backRoom()) {
+            throw std::out_of_range("Not enough reserved room");
+        }
+
+        size += count;
+    }
+
+    void ShrinkToFit() {
+        if (size < capacity) {
+            _reallocate(size, 0);
+        }
+    }
+
+    // Growing default-constructs the new tail; shrinking destroys it but keeps the capacity.
     void Resize(int newSize) {
-        int newCapacity = _getCapacity(newSize);
-        if (capacity == newCapacity) { 
+        if (newSize < size) {
+            _destroy(data + newSize, data + size);
             size = newSize;
             return;
         }
 
-        T* newData = new T[newCapacity];
-        std::copy(data, data + std::min(size, newSize), newData);
-        delete[] data;
-        data = newData;
-        capacity = newCapacity;
+        if (newSize - size > _backRoom()) {
+            _reallocate(std::max(capacity, _getCapacity(newSize)), 0);
+        }
+        _constructAll(data + size, newSize - size, [](int) { return T(); });
         size = newSize;
     }
 
@@ -78,9 +337,144 @@ public:
         data[index] = value;
     }
 
+    void Set(T&& value, int index) {
+        _checkException(index);
+
+        data[index] = std::move(value);
+    }
+
+    // When the block has to move, the value is built first, since the arguments may
+    // refer to elements of this array.
+    template <typename... Args>
+    void EmplaceBack(Args&&... args) {
+        Instrument::Construction<T, Args...>();
+        if (_backRoom() > 0) {
+            AllocatorTraits::construct(allocator, data + size, std::forward<Args>(args)...);
+        } else {
+            T value(std::forward<Args>(args)...);
+            _makeRoom(false);
+            AllocatorTraits::construct(allocator, data + size, std::move(value));
+        }
+        ++size;
+    }
+
+    template <typename... Args>
+    void EmplaceFront(Args&&... args) {
+        Instrument::Construction<T, Args...>();
+        if (_frontRoom() > 0) {
+            AllocatorTraits::construct(allocator, data - 1, std::forward<Args>(args)...);
+        } else {
+            T value(std::forward<Args>(args)...);
+            _makeRoom(true);
+            AllocatorTraits::construct(allocator, data - 1, std::move(value));
+        }
+        --data;
+        ++size;
+    }
+
+    template <typename... Args>
+    void EmplaceAt(int index, Args&&... args) {
+        if (index < 0 || index > size) {
+            throw std::out_of_range("Index out of range");
+        }
+
+        if (index == 0) {
+            EmplaceFront(std::forward<Args>(args)...);
+            return;
+        }
+        if (index == size) {
+            EmplaceBack(std::forward<Args>(args)...);
+            return;
+        }
+
+        Instrument::Construction<T, Args...>();
+        T value(std::forward<Args>(args)...);
+        bool atFront = index < size - index;
+        if ((atFront ? _frontRoom() : _backRoom()) == 0) {
+            _makeRoom(atFront);
+        }
+
+        if (atFront) {
+            _insertShiftingFront(std::move(value), index);
+        } else {
+            _insertShiftingBack(std::move(value), index);
+        }
+    }
+
+    void PopBack() {
+        if (size == 0) {
+            throw std::out_of_range("Array is empty");
+        }
+
+        AllocatorTraits::destroy(allocator, data + size - 1);
+        --size;
+    }
+
+    void PopFront() {
+        if (size == 0) {
+            throw std::out_of_range("Array is empty");
+        }
+
+        AllocatorTraits::destroy(allocator, data);
+        ++data;
+        --size;
+    }
+
+    void RemoveAt(int index) {
+        RemoveRange(index, index);
+    }
+
+    // Removes [startIndex, endIndex] by moving whichever side of the gap is shorter; a gap
+    // at the front just becomes headroom.
+    void RemoveRange(int startIndex, int endIndex) {
+        _checkException(startIndex);
+        _checkException(endIndex);
+        if (startIndex > endIndex) {
+            throw std::invalid_argument("Invalid range");
+        }
+
+        int count = endIndex - startIndex + 1;
+        if (startIndex < size - 1 - endIndex) {
+            Instrument::Moves(startIndex);
+            std::move_backward(data, data + startIndex, data + endIndex + 1);
+            _destroy(data, data + count);
+            data += count;
+        } else {
+            Instrument::Moves(size - 1 - endIndex);
+            std::move(data + endIndex + 1, data + size, data + startIndex);
+            _destroy(data + size - count, data + size);
+        }
+        size -= count;
+    }
+
+    // Keeps the order of the remaining elements and returns how many were removed.
+    template <typename Predicate>
+    int RemoveIf(Predicate predicate) {
+        T* out = data;
+        for (T* current = data; current != data + size; ++current) {
+            if (!predicate(*current)) {
+                if (out != current) {
+                    Instrument::Moves(1);
+                    *out = std::move(*current);
+                }
+                ++out;
+            }
+        }
+
+        int removed = static_cast<int>(data + size - out);
+        _destroy(out, data + size);
+        size -= removed;
+        return removed;
+    }
+
     T& Get(int index) const {
         _checkException(index);
 
         return data[index];
     }
+
+    // Get without the bounds check, for callers that have already validated the index.
+    T& GetUnchecked(int index) const {
+        return data[index];
+    }
 };
\ No newline at end of file
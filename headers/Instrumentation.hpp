@@ -0,0 +1,128 @@
+#pragma once
+#include <tuple>
+#include <type_traits>
+
+
+// Per-thread counters of the work done by the containers: storage blocks and nodes they
+// allocate, elements they copy or move (construction, relocation and shifting), clones of
+// immutable sequences, segment splits and buffer regrowths. Counting is compiled in only
+// when SEQUENCES_INSTRUMENTATION is defined, and every translation unit of a program must
+// agree on it. Otherwise the hooks are empty and Snapshot() always returns zeros.
+// Work done on thread pool workers is counted on those threads.
+struct SequenceStats {
+    long long allocations = 0;
+    long long bytesAllocated = 0;
+    long long copies = 0;
+    long long moves = 0;
+    long long clones = 0;
+    long long segmentSplits = 0;
+    long long regrowths = 0;
+
+#ifdef SEQUENCES_INSTRUMENTATION
+    static constexpr bool enabled = true;
+
+    static SequenceStats& Local() {
+        thread_local SequenceStats stats;
+        return stats;
+    }
+#else
+    static constexpr bool enabled = false;
+#endif
+
+    static SequenceStats Snapshot() {
+#ifdef SEQUENCES_INSTRUMENTATION
+        return Local();
+#else
+        return SequenceStats();
+#endif
+    }
+
+    static void Reset() {
+#ifdef SEQUENCES_INSTRUMENTATION
+        Local() = SequenceStats();
+#endif
+    }
+
+    SequenceStats operator-(const SequenceStats& other) const {
+        SequenceStats ret;
+        ret.allocations = allocations - other.allocations;
+        ret.bytesAllocated = bytesAllocated - other.bytesAllocated;
+        ret.copies = copies - other.copies;
+        ret.moves = moves - other.moves;
+        ret.clones = clones - other.clones;
+        ret.segmentSplits = segmentSplits - other.segmentSplits;
+        ret.regrowths = regrowths - other.regrowths;
+        return ret;
+    }
+};
+
+
+// Hooks called by the containers; each compiles to nothing without SEQUENCES_INSTRUMENTATION.
+struct Instrument {
+    static void Allocation([[maybe_unused]] long long bytes) {
+#ifdef SEQUENCES_INSTRUMENTATION
+        ++SequenceStats::Local().allocations;
+        SequenceStats::Local().bytesAllocated += bytes;
+#endif
+    }
+
+    static void Copies([[maybe_unused]] long long count) {
+#ifdef SEQUENCES_INSTRUMENTATION
+        SequenceStats::Local().copies += count;
+#endif
+    }
+
+    static void Moves([[maybe_unused]] long long count) {
+#ifdef SEQUENCES_INSTRUMENTATION
+        SequenceStats::Local().moves += count;
+#endif
+    }
+
+    // One element built from Args: a copy or a move when the only argument is a T, and
+    // neither when it is emplaced from other arguments.
+    template <typename T, typename... Args>
+    static void Construction() {
+#ifdef SEQUENCES_INSTRUMENTATION
+        if constexpr (sizeof...(Args) == 1) {
+            using Arg = std::tuple_element_t<0, std::tuple<Args...>>;
+            if constexpr (std::is_same_v<std::decay_t<Arg>, T>) {
+                if constexpr (std::is_lvalue_reference_v<Arg> || std::is_const_v<std::remove_reference_t<Arg>>) {
+                    Copies(1);
+                } else {
+                    Moves(1);
+                }
+            }
+        }
+#endif
+    }
+
+    // count elements transferred with std::move_if_noexcept.
+    template <typename T>
+    static void Relocation([[maybe_unused]] long long count) {
+#ifdef SEQUENCES_INSTRUMENTATION
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            Moves(count);
+        } else {
+            Copies(count);
+        }
+#endif
+    }
+
+    static void Clone() {
+#ifdef SEQUENCES_INSTRUMENTATION
+        ++SequenceStats::Local().clones;
+#endif
+    }
+
+    static void SegmentSplit() {
+#ifdef SEQUENCES_INSTRUMENTATION
+        ++SequenceStats::Local().segmentSplits;
+#endif
+    }
+
+    static void Regrowth() {
+#ifdef SEQUENCES_INSTRUMENTATION
+        ++SequenceStats::Local().regrowths;
+#endif
+    }
+};
@@ -0,0 +1,15 @@
+#pragma once
+#include <iterator>
+#include <type_traits>
+
+
+// Restricts iterator-pair constructors to real iterators, so calls such as (items, count)
+// or (count, value) never resolve to them.
+template <typename Iterator>
+using EnableIfInputIterator = std::enable_if_t<
+    std::is_convertible_v<typename std::iterator_traits<Iterator>::iterator_category, std::input_iterator_tag>>;
+
+// Forward iterators can be walked twice, so the length of the range can be taken up front.
+template <typename Iterator>
+struct IsForwardIterator
+    : std::is_convertible<typename std::iterator_traits<Iterator>::iterator_category, std::forward_iterator_tag> {};
@@ -2,9 +2,18 @@
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <memory>
+#include "PoolAllocator.hpp"
+#include "IteratorTraits.hpp"
+#include "Instrumentation.hpp"
 
 
-template <typename T>
+// Nodes come from Allocator, rebound to the node type. The default pool allocator keeps
+// them in contiguous chunks and reuses freed ones instead of calling new for each node.
+template <typename T, typename Allocator = PoolAllocator<T>>
 class LinkedList {
 private:
     struct Node {
@@ -12,44 +21,264 @@ private:
         Node* next;
         Node* prev;
 
-        Node(const T& value) : data(value), next(nullptr), prev(nullptr) {}
+        template <typename... Args>
+        explicit Node(Args&&... args) : data(std::forward<Args>(args)...), next(nullptr), prev(nullptr) {}
     };
 
+    using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+    using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+    NodeAllocator allocator;
     Node* head;
     Node* tail;
     int size;
 
+    // Last node reached by index. Walks start from whichever of head, tail and this finger
+    // is closest, so scans over consecutive indices cost O(1) per step.
+    Node* finger;
+    int fingerIndex;
+
+    template <typename... Args>
+    Node* _createNode(Args&&... args) {
+        // A pool counts the chunks it takes from the system, not the slots it hands out.
+        if constexpr (!IsPoolAllocator<NodeAllocator>::value) {
+            Instrument::Allocation(sizeof(Node));
+        }
+        Instrument::Construction<T, Args...>();
+        Node* node = NodeTraits::allocate(allocator, 1);
+        try {
+            NodeTraits::construct(allocator, node, std::forward<Args>(args)...);
+        } catch (...) {
+            NodeTraits::deallocate(allocator, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    void _destroyNode(Node* node) {
+        NodeTraits::destroy(allocator, node);
+        NodeTraits::deallocate(allocator, node, 1);
+    }
+
+    // Read-only walk, so concurrent const lookups never write to the list.
+    Node* _findNode(int index) const {
+        Node* current = head;
+        int position = 0;
+        if (size - 1 - index < index) {
+            current = tail;
+            position = size - 1;
+        }
+        if (finger != nullptr) {
+            int fromFinger = fingerIndex < index ? index - fingerIndex : fingerIndex - index;
+            int fromEnd = position < index ? index - position : position - index;
+            if (fromFinger < fromEnd) {
+                current = finger;
+                position = fingerIndex;
+            }
+        }
+
+        for (; position < index; ++position) {
+            current = current->next;
+        }
+        for (; position > index; --position) {
+            current = current->prev;
+        }
+        return current;
+    }
+
+    // Lookups on the non-const paths also move the finger to the node they reach.
+    Node* _nodeAt(int index) {
+        finger = _findNode(index);
+        fingerIndex = index;
+        return finger;
+    }
+
+    // Nodes may move to another list only if that list's allocator can free them later.
+    bool _canRelink(LinkedList& other) {
+        if constexpr (IsPoolAllocator<NodeAllocator>::value) {
+            return allocator.Merge(other.allocator);
+        } else if constexpr (NodeTraits::is_always_equal::value) {
+            return true;
+        } else {
+            return allocator == other.allocator;
+        }
+    }
+
+    // Unlinks the nodes [startIndex, endIndex] and returns both ends of the detached chain.
+    std::pair<Node*, Node*> _detach(int startIndex, int endIndex) {
+        Node* first = _nodeAt(startIndex);
+        Node* last = _nodeAt(endIndex);
+        (first->prev != nullptr ? first->prev->next : head) = last->next;
+        (last->next != nullptr ? last->next->prev : tail) = first->prev;
+        first->prev = last->next = nullptr;
+        size -= endIndex - startIndex + 1;
+        finger = nullptr;
+        return {first, last};
+    }
+
+    // Links a detached chain of count nodes in before position index.
+    void _attach(int index, Node* first, Node* last, int count) {
+        Node* next = index == size ? nullptr : _nodeAt(index);
+        Node* prev = next == nullptr ? tail : next->prev;
+        first->prev = prev;
+        last->next = next;
+        (prev != nullptr ? prev->next : head) = first;
+        (next != nullptr ? next->prev : tail) = last;
+        size += count;
+        finger = nullptr;
+    }
+
+    struct _SharedAllocator {};
+
+    LinkedList(_SharedAllocator, const NodeAllocator& allocator_)
+        : allocator(allocator_), head(nullptr), tail(nullptr), size(0), finger(nullptr), fingerIndex(0) {}
+
     void _checkException(int index) const {
-        if (index >= size) {
+        if (index < 0 || index >= size) {
             throw std::out_of_range("Index out of range");
         }
     }
 
+    template <bool IsConst>
+    class ListIterator {
+    private:
+        friend class LinkedList;
+        template <bool> friend class ListIterator;
+
+        Node* node;
+        const LinkedList* list;
+
+        ListIterator(Node* node_, const LinkedList* list_) : node(node_), list(list_) {}
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+
+        ListIterator() : node(nullptr), list(nullptr) {}
+
+        template <bool WasConst, typename = std::enable_if_t<IsConst && !WasConst>>
+        ListIterator(const ListIterator<WasConst>& other) : node(other.node), list(other.list) {}
+
+        reference operator*() const {
+            return node->data;
+        }
+
+        pointer operator->() const {
+            return &node->data;
+        }
+
+        ListIterator& operator++() {
+            node = node->next;
+            return *this;
+        }
+
+        ListIterator operator++(int) {
+            ListIterator ret = *this;
+            ++(*this);
+            return ret;
+        }
+
+        ListIterator& operator--() {
+            node = node == nullptr ? list->tail : node->prev;
+            return *this;
+        }
+
+        ListIterator operator--(int) {
+            ListIterator ret = *this;
+            --(*this);
+            return ret;
+        }
+
+        bool operator==(const ListIterator& other) const {
+            return node == other.node;
+        }
+
+        bool operator!=(const ListIterator& other) const {
+            return node != other.node;
+        }
+    };
+
 public:
-    LinkedList(): head(nullptr), tail(nullptr), size(0) {}
-    LinkedList(const T* items, int count) : head(nullptr), tail(nullptr), size(0) {
+    using Iterator = ListIterator<false>;
+    using ConstIterator = ListIterator<true>;
+
+    LinkedList(): allocator(), head(nullptr), tail(nullptr), size(0), finger(nullptr), fingerIndex(0) {}
+    explicit LinkedList(const Allocator& allocator_)
+        : allocator(allocator_), head(nullptr), tail(nullptr), size(0), finger(nullptr), fingerIndex(0) {}
+    LinkedList(const T* items, int count)
+        : allocator(), head(nullptr), tail(nullptr), size(0), finger(nullptr), fingerIndex(0) {
         for (int i = 0; i < count; ++i) {
             Append(items[i]);
         }
     }
-    LinkedList(const LinkedList<T>& other) : head(nullptr), tail(nullptr), size(0) {
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    LinkedList(InputIterator first, InputIterator last) : LinkedList() {
+        for (; first != last; ++first) {
+            EmplaceBack(*first);
+        }
+    }
+    LinkedList(const LinkedList& other)
+        : allocator(NodeTraits::select_on_container_copy_construction(other.allocator)),
+          head(nullptr), tail(nullptr), size(0), finger(nullptr), fingerIndex(0) {
         for (Node* current = other.head; current != nullptr; current = current->next) {
             Append(current->data);
         }
     }
 
+    LinkedList(LinkedList&& other) noexcept
+        : allocator(std::move(other.allocator)), head(other.head), tail(other.tail), size(other.size),
+          finger(other.finger), fingerIndex(other.fingerIndex) {
+        other.head = other.tail = other.finger = nullptr;
+        other.size = 0;
+    }
+
     ~LinkedList() {
         Clear();
     }
 
+    LinkedList& operator=(const LinkedList& other) {
+        if (this != &other) {
+            LinkedList copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    LinkedList& operator=(LinkedList&& other) noexcept {
+        if (this != &other) {
+            Clear();
+            if constexpr (NodeTraits::propagate_on_container_move_assignment::value) {
+                allocator = std::move(other.allocator);
+            }
+            head = other.head;
+            tail = other.tail;
+            size = other.size;
+            finger = other.finger;
+            fingerIndex = other.fingerIndex;
+            other.head = other.tail = other.finger = nullptr;
+            other.size = 0;
+        }
+        return *this;
+    }
+
+    // With a pool of its own and nothing to destroy, the list hands back whole chunks.
     void Clear() {
+        if constexpr (IsPoolAllocator<NodeAllocator>::value && std::is_trivially_destructible_v<Node>) {
+            if (head != nullptr && allocator.Release()) {
+                head = nullptr;
+            }
+        }
+
         while (head != nullptr) {
             Node* temp = head;
             head = head->next;
-            delete temp;
+            _destroyNode(temp);
         }
 
-        tail = nullptr;
+        tail = finger = nullptr;
         size = 0;
     }
 
@@ -57,8 +286,41 @@ public:
         return size;
     }
 
+    Iterator begin() {
+        return Iterator(head, this);
+    }
+
+    Iterator end() {
+        return Iterator(nullptr, this);
+    }
+
+    ConstIterator begin() const {
+        return ConstIterator(head, this);
+    }
+
+    ConstIterator end() const {
+        return ConstIterator(nullptr, this);
+    }
+
     void Append(const T& value) {
-        Node* newNode = new Node(value);
+        EmplaceBack(value);
+    }
+
+    void Append(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void Prepend(const T& value) {
+        EmplaceFront(value);
+    }
+
+    void Prepend(T&& value) {
+        EmplaceFront(std::move(value));
+    }
+
+    template <typename... Args>
+    void EmplaceBack(Args&&... args) {
+        Node* newNode = _createNode(std::forward<Args>(args)...);
         if (tail == nullptr) {
             head = tail = newNode;
         } else {
@@ -69,8 +331,9 @@ public:
         ++size;
     }
 
-    void Prepend(const T& value) {
-        Node* newNode = new Node(value);
+    template <typename... Args>
+    void EmplaceFront(Args&&... args) {
+        Node* newNode = _createNode(std::forward<Args>(args)...);
         if (head == nullptr) {
             head = tail = newNode;
         } else {
@@ -78,16 +341,26 @@ public:
             head->prev = newNode;
             head = newNode;
         }
+        ++fingerIndex;
         ++size;
     }
 
     T& Get(int index) const {
         _checkException(index);
-        Node* current = head;
-        for (int i = 0; i < index; ++i) {
-            current = current->next;
-        }
-        return current->data;
+        return _findNode(index)->data;
+    }
+
+    T& Get(int index) {
+        _checkException(index);
+        return _nodeAt(index)->data;
+    }
+
+    T& GetUnchecked(int index) const {
+        return _findNode(index)->data;
+    }
+
+    T& GetUnchecked(int index) {
+        return _nodeAt(index)->data;
     }
 
     T& GetFirst() const {
@@ -103,27 +376,195 @@ public:
     }
 
     void InsertAt(const T& item, int index) {
+        EmplaceAt(index, item);
+    }
+
+    void InsertAt(T&& item, int index) {
+        EmplaceAt(index, std::move(item));
+    }
+
+    template <typename... Args>
+    void EmplaceAt(int index, Args&&... args) {
         _checkException(index);
         if (index == 0) {
-            Prepend(item);
+            EmplaceFront(std::forward<Args>(args)...);
         } else if (index == size) {
-            Append(item);
+            EmplaceBack(std::forward<Args>(args)...);
         } else {
-            Node* newNode = new Node(item);
-            Node* current = head;
-            for (int i = 0; i < index; ++i) {
-                current = current->next;
-            }
+            Node* newNode = _createNode(std::forward<Args>(args)...);
+            Node* current = _nodeAt(index);
             newNode->prev = current->prev;
             newNode->next = current;
             current->prev->next = newNode;
             current->prev = newNode;
+            finger = newNode;
             ++size;
         }
     }
 
-    LinkedList<T>* Concat(const LinkedList<T>* list) {
-        LinkedList<T>* result = new LinkedList<T>(*this);
+    void PopFront() {
+        if (size == 0) {
+            throw std::out_of_range("List is empty");
+        }
+
+        Node* node = head;
+        head = head->next;
+        (head != nullptr ? head->prev : tail) = nullptr;
+        if (finger == node) {
+            finger = nullptr;
+        } else {
+            --fingerIndex;
+        }
+        --size;
+        _destroyNode(node);
+    }
+
+    void PopBack() {
+        if (size == 0) {
+            throw std::out_of_range("List is empty");
+        }
+
+        Node* node = tail;
+        tail = tail->prev;
+        (tail != nullptr ? tail->next : head) = nullptr;
+        if (finger == node) {
+            finger = nullptr;
+        }
+        --size;
+        _destroyNode(node);
+    }
+
+    void RemoveAt(int index) {
+        _checkException(index);
+        if (index == 0) {
+            PopFront();
+        } else if (index == size - 1) {
+            PopBack();
+        } else {
+            RemoveRange(index, index);
+        }
+    }
+
+    // Frees the nodes [startIndex, endIndex]; the finger moves to the node after the gap.
+    void RemoveRange(int startIndex, int endIndex) {
+        _checkException(startIndex);
+        _checkException(endIndex);
+        if (startIndex > endIndex) {
+            throw std::invalid_argument("Invalid range");
+        }
+
+        Node* after = _nodeAt(endIndex)->next;
+        Node* first = _detach(startIndex, endIndex).first;
+        while (first != nullptr) {
+            Node* next = first->next;
+            _destroyNode(first);
+            first = next;
+        }
+        if (after != nullptr) {
+            finger = after;
+            fingerIndex = startIndex;
+        }
+    }
+
+    // Keeps the order of the remaining elements and returns how many were removed.
+    template <typename Predicate>
+    int RemoveIf(Predicate predicate) {
+        finger = nullptr;
+        int removed = 0;
+        Node* current = head;
+        while (current != nullptr) {
+            Node* next = current->next;
+            if (predicate(current->data)) {
+                (current->prev != nullptr ? current->prev->next : head) = next;
+                (next != nullptr ? next->prev : tail) = current->prev;
+                _destroyNode(current);
+                --size;
+                ++removed;
+            }
+            current = next;
+        }
+        return removed;
+    }
+
+    // Destructive splices: nodes are relinked rather than copied and `other` loses them.
+    // If the two allocators cannot free each other's nodes, elements are moved one by one.
+    void ConcatMove(LinkedList& other) {
+        if (&other == this) {
+            throw std::invalid_argument("Cannot splice a list into itself");
+        }
+        if (other.size == 0) {
+            return;
+        }
+
+        if (_canRelink(other)) {
+            Node* first = other.head;
+            Node* last = other.tail;
+            int count = other.size;
+            other.head = other.tail = other.finger = nullptr;
+            other.size = 0;
+            _attach(size, first, last, count);
+        } else {
+            for (T& item : other) {
+                EmplaceBack(std::move(item));
+            }
+            other.Clear();
+        }
+    }
+
+    // Moves the elements [startIndex, endIndex] of other in front of position index.
+    void SpliceRange(int index, LinkedList& other, int startIndex, int endIndex) {
+        if (&other == this) {
+            throw std::invalid_argument("Cannot splice a list into itself");
+        }
+        if (index < 0 || index > size) {
+            throw std::out_of_range("Index out of range");
+        }
+        other._checkException(startIndex);
+        other._checkException(endIndex);
+        if (startIndex > endIndex) {
+            throw std::invalid_argument("Invalid splice range");
+        }
+
+        int count = endIndex - startIndex + 1;
+        if (!_canRelink(other)) {
+            Node* current = other._nodeAt(startIndex);
+            for (int i = 0; i < count; ++i, current = current->next) {
+                if (index + i == size) {
+                    EmplaceBack(std::move(current->data));
+                } else {
+                    EmplaceAt(index + i, std::move(current->data));
+                }
+            }
+            Node* first = other._detach(startIndex, endIndex).first;
+            while (first != nullptr) {
+                Node* next = first->next;
+                other._destroyNode(first);
+                first = next;
+            }
+            return;
+        }
+
+        auto [first, last] = other._detach(startIndex, endIndex);
+        _attach(index, first, last, count);
+    }
+
+    // Cuts the list before position index and returns the part from index on.
+    LinkedList* SplitAt(int index) {
+        if (index < 0 || index > size) {
+            throw std::out_of_range("Index out of range");
+        }
+
+        LinkedList* result = new LinkedList(_SharedAllocator(), allocator);
+        if (index < size) {
+            int count = size - index;
+            auto [first, last] = _detach(index, size - 1);
+            result->_attach(0, first, last, count);
+        }
+        return result;
+    }
+
+    LinkedList* Concat(const LinkedList* list) {
+        LinkedList* result = new LinkedList(*this);
 
         Node* current = list->head;
         while (current != nullptr) {
@@ -134,26 +575,19 @@ public:
         return result;
     }
 
-    LinkedList<T>* GetSubList(int startIndex, int endIndex) {
+    LinkedList* GetSubList(int startIndex, int endIndex) const {
         _checkException(startIndex);
         _checkException(endIndex);
 
-        LinkedList<T>* result = new LinkedList<T>();
+        LinkedList* result = new LinkedList();
 
+        Node* current = _findNode(startIndex);
         if (startIndex <= endIndex) {
-            Node* current = head;
-            for (int i = 0; i < startIndex; ++i) {
-                current = current->next;
-            }
             for (int i = startIndex; i <= endIndex; ++i) {
                 result->Append(current->data);
                 current = current->next;
             }
         } else {
-            Node* current = tail;
-            for (int i = size - 1; startIndex < i; --i) {
-                current = current->prev;
-            }
             for (int i = startIndex; endIndex <= i; --i) {
                 result->Append(current->data);
                 current = current->prev;
@@ -0,0 +1,147 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// Fixed set of worker threads that run index-parallel jobs. The calling thread takes
+// part in every job, so a pool of concurrency N owns N - 1 workers.
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+
+    std::mutex runMutex;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    const std::function<void(int)>* job;
+    int jobSize;
+    std::atomic<int> next;
+    int active;
+    unsigned generation;
+    bool stopping;
+    std::exception_ptr error;
+
+    static bool& _insideJob() {
+        thread_local bool inside = false;
+        return inside;
+    }
+
+    void _work() {
+        bool& inside = _insideJob();
+        inside = true;
+        for (int i = next.fetch_add(1); i < jobSize; i = next.fetch_add(1)) {
+            try {
+                (*job)(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) error = std::current_exception();
+            }
+        }
+        inside = false;
+    }
+
+    void _workerLoop() {
+        unsigned seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+
+            _work();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--active == 0) done.notify_all();
+        }
+    }
+
+public:
+    explicit ThreadPool(int concurrency)
+        : job(nullptr), jobSize(0), next(0), active(0), generation(0), stopping(false) {
+        for (int i = 1; i < concurrency; ++i) {
+            workers.emplace_back([this] { _workerLoop(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    static ThreadPool& Default() {
+        static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+        return pool;
+    }
+
+    int GetConcurrency() const {
+        return static_cast<int>(workers.size()) + 1;
+    }
+
+    // Calls task(i) for every i in [0, count) and returns once all calls are finished.
+    // Jobs started from inside a task run sequentially on the calling thread.
+    void Run(int count, const std::function<void(int)>& task) {
+        if (workers.empty() || count <= 1 || _insideJob()) {
+            for (int i = 0; i < count; ++i) {
+                task(i);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> runLock(runMutex);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &task;
+            jobSize = count;
+            next = 0;
+            active = static_cast<int>(workers.size());
+            error = nullptr;
+            ++generation;
+        }
+        wake.notify_all();
+
+        _work();
+
+        std::exception_ptr failure;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [&] { return active == 0; });
+            job = nullptr;
+            failure = error;
+            error = nullptr;
+        }
+        if (failure) std::rethrow_exception(failure);
+    }
+};
+
+
+// Execution policy for the parallel Map/Where/Reduce overloads. Sequences shorter than
+// minLength, or whose storage is not made of contiguous runs, are processed sequentially.
+struct ParallelPolicy {
+    ThreadPool* pool = nullptr;
+    int minLength = 1 << 14;
+    int minGrain = 1 << 12;
+
+    ThreadPool& GetPool() const {
+        return pool != nullptr ? *pool : ThreadPool::Default();
+    }
+};
+
+inline const ParallelPolicy par{};
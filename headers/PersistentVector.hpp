@@ -0,0 +1,636 @@
+#pragma once
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <memory>
+#include <iterator>
+#include <utility>
+#include "IteratorTraits.hpp"
+#include "Instrumentation.hpp"
+#include "DynamicArray.hpp"
+
+
+// Persistent sequence container: a size-annotated AVL tree whose nodes each hold a run
+// of up to chunkCapacity elements. Nodes and runs are shared between versions;
+// Append/Prepend/InsertAt/Concat/GetSubVector copy only the O(log N) nodes on the
+// affected paths plus the runs they cut or grow, and leave the original untouched.
+// Scans see the runs as contiguous storage.
+template <typename T>
+class PersistentVector {
+private:
+    struct Node;
+    using NodePtr = std::shared_ptr<Node>;
+    using Chunk = DynamicArray<T>;
+    using ChunkPtr = std::shared_ptr<Chunk>;
+
+    static constexpr int chunkCapacity = std::max(4, static_cast<int>(256 / sizeof(T)));
+
+    struct Node {
+        ChunkPtr chunk;
+        NodePtr left;
+        NodePtr right;
+        int size;
+        int height;
+
+        Node(const NodePtr& l, const ChunkPtr& c, const NodePtr& r)
+            : chunk(c), left(l), right(r),
+              size(_size(l) + _size(r) + c->GetSize()),
+              height(std::max(_height(l), _height(r)) + 1) {}
+    };
+
+    NodePtr root;
+
+    static int _size(const NodePtr& node) {
+        return node ? node->size : 0;
+    }
+
+    static int _height(const NodePtr& node) {
+        return node ? node->height : 0;
+    }
+
+    static NodePtr _make(const NodePtr& left, const ChunkPtr& chunk, const NodePtr& right) {
+        Instrument::Allocation(sizeof(Node));
+        return std::make_shared<Node>(left, chunk, right);
+    }
+
+    static ChunkPtr _newChunk(int capacity) {
+        ChunkPtr chunk = std::make_shared<Chunk>();
+        chunk->Reserve(capacity);
+        return chunk;
+    }
+
+    template <typename U>
+    static ChunkPtr _single(U&& value) {
+        ChunkPtr chunk = _newChunk(1);
+        chunk->EmplaceBack(std::forward<U>(value));
+        return chunk;
+    }
+
+    // Copies [from, to) of first followed by all of second (if any) into a new run.
+    static ChunkPtr _slice(const Chunk& first, int from, int to, const Chunk* second = nullptr) {
+        ChunkPtr chunk = _newChunk(to - from + (second != nullptr ? second->GetSize() : 0));
+        for (int i = from; i < to; ++i) {
+            chunk->EmplaceBack(first.GetUnchecked(i));
+        }
+        for (int i = 0; second != nullptr && i < second->GetSize(); ++i) {
+            chunk->EmplaceBack(second->GetUnchecked(i));
+        }
+        return chunk;
+    }
+
+    static const ChunkPtr& _firstChunk(const NodePtr& node) {
+        const Node* current = node.get();
+        while (current->left) {
+            current = current->left.get();
+        }
+        return current->chunk;
+    }
+
+    static const ChunkPtr& _lastChunk(const NodePtr& node) {
+        const Node* current = node.get();
+        while (current->right) {
+            current = current->right.get();
+        }
+        return current->chunk;
+    }
+
+    static NodePtr _rotateLeft(const NodePtr& node) {
+        const NodePtr& r = node->right;
+        return _make(_make(node->left, node->chunk, r->left), r->chunk, r->right);
+    }
+
+    static NodePtr _rotateRight(const NodePtr& node) {
+        const NodePtr& l = node->left;
+        return _make(l->left, l->chunk, _make(l->right, node->chunk, node->right));
+    }
+
+    static NodePtr _joinRight(const NodePtr& left, const ChunkPtr& chunk, const NodePtr& right) {
+        if (_height(left->right) <= _height(right) + 1) {
+            NodePtr middle = _make(left->right, chunk, right);
+            if (_height(middle) <= _height(left->left) + 1) {
+                return _make(left->left, left->chunk, middle);
+            }
+            return _rotateLeft(_make(left->left, left->chunk, _rotateRight(middle)));
+        }
+
+        NodePtr middle = _joinRight(left->right, chunk, right);
+        NodePtr ret = _make(left->left, left->chunk, middle);
+        if (_height(middle) <= _height(left->left) + 1) {
+            return ret;
+        }
+        return _rotateLeft(ret);
+    }
+
+    static NodePtr _joinLeft(const NodePtr& left, const ChunkPtr& chunk, const NodePtr& right) {
+        if (_height(right->left) <= _height(left) + 1) {
+            NodePtr middle = _make(left, chunk, right->left);
+            if (_height(middle) <= _height(right->right) + 1) {
+                return _make(middle, right->chunk, right->right);
+            }
+            return _rotateRight(_make(_rotateLeft(middle), right->chunk, right->right));
+        }
+
+        NodePtr middle = _joinLeft(left, chunk, right->left);
+        NodePtr ret = _make(middle, right->chunk, right->right);
+        if (_height(middle) <= _height(right->right) + 1) {
+            return ret;
+        }
+        return _rotateRight(ret);
+    }
+
+    static NodePtr _join(const NodePtr& left, const ChunkPtr& chunk, const NodePtr& right) {
+        if (_height(left) > _height(right) + 1) {
+            return _joinRight(left, chunk, right);
+        }
+        if (_height(right) > _height(left) + 1) {
+            return _joinLeft(left, chunk, right);
+        }
+        return _make(left, chunk, right);
+    }
+
+    // An index inside a run cuts it in two; an index on a run boundary shares the run as is.
+    static std::pair<NodePtr, NodePtr> _split(const NodePtr& node, int index) {
+        if (!node) {
+            return {nullptr, nullptr};
+        }
+
+        int leftSize = _size(node->left);
+        int count = node->chunk->GetSize();
+        if (index <= leftSize) {
+            auto [l, r] = _split(node->left, index);
+            return {l, _join(r, node->chunk, node->right)};
+        }
+        if (index >= leftSize + count) {
+            auto [l, r] = _split(node->right, index - leftSize - count);
+            return {_join(node->left, node->chunk, l), r};
+        }
+
+        int cut = index - leftSize;
+        return {_join(node->left, _slice(*node->chunk, 0, cut), nullptr),
+                _join(nullptr, _slice(*node->chunk, cut, count), node->right)};
+    }
+
+    // The runs meeting at the junction are merged when they fit in one, so repeated small
+    // appends, prepends and removals keep the runs full.
+    static NodePtr _concat(const NodePtr& left, const NodePtr& right) {
+        if (!left) return right;
+        if (!right) return left;
+
+        const ChunkPtr& last = _lastChunk(left);
+        const ChunkPtr& first = _firstChunk(right);
+        if (last->GetSize() + first->GetSize() <= chunkCapacity) {
+            ChunkPtr merged = _slice(*last, 0, last->GetSize(), first.get());
+            if (right->size == first->GetSize()) {
+                return _withLastChunk(left, merged);
+            }
+            if (left->size == last->GetSize()) {
+                return _withFirstChunk(right, merged);
+            }
+            NodePtr head = _split(left, left->size - last->GetSize()).first;
+            return _join(head, merged, _split(right, first->GetSize()).second);
+        }
+        if (right->size == first->GetSize()) {
+            return _join(left, first, nullptr);
+        }
+        return _join(left, first, _split(right, first->GetSize()).second);
+    }
+
+    // Copies the path to the last (first) run with that run replaced; heights stay the same.
+    static NodePtr _withLastChunk(const NodePtr& node, const ChunkPtr& chunk) {
+        if (!node->right) {
+            return _make(node->left, chunk, nullptr);
+        }
+        return _make(node->left, node->chunk, _withLastChunk(node->right, chunk));
+    }
+
+    static NodePtr _withFirstChunk(const NodePtr& node, const ChunkPtr& chunk) {
+        if (!node->left) {
+            return _make(nullptr, chunk, node->right);
+        }
+        return _make(_withFirstChunk(node->left, chunk), node->chunk, node->right);
+    }
+
+    // Subtrees without a removed element are shared with the original version as they are.
+    template <typename Predicate>
+    static NodePtr _removeIf(const NodePtr& node, Predicate& predicate) {
+        if (!node) {
+            return nullptr;
+        }
+
+        NodePtr left = _removeIf(node->left, predicate);
+        const Chunk& chunk = *node->chunk;
+        ChunkPtr kept = nullptr;
+        for (int i = 0; i < chunk.GetSize(); ++i) {
+            bool drop = predicate(chunk.GetUnchecked(i));
+            if (drop && kept == nullptr) {
+                kept = _slice(chunk, 0, i);
+            } else if (!drop && kept != nullptr) {
+                kept->EmplaceBack(chunk.GetUnchecked(i));
+            }
+        }
+        NodePtr right = _removeIf(node->right, predicate);
+        if (kept == nullptr) {
+            if (left == node->left && right == node->right) {
+                return node;
+            }
+            return _join(left, node->chunk, right);
+        }
+        if (kept->GetSize() == 0) {
+            return _concat(left, right);
+        }
+        return _concat(_concat(left, _make(nullptr, kept, nullptr)), right);
+    }
+
+    // Fills full runs in index order, so a getter may consume a single-pass source.
+    template <typename Getter>
+    static NodePtr _build(Getter& getter, int count, int firstChunk, int lastChunk) {
+        if (firstChunk >= lastChunk) {
+            return nullptr;
+        }
+
+        int mid = firstChunk + (lastChunk - firstChunk) / 2;
+        NodePtr left = _build(getter, count, firstChunk, mid);
+        int end = std::min(count, (mid + 1) * chunkCapacity);
+        ChunkPtr chunk = _newChunk(end - mid * chunkCapacity);
+        for (int i = mid * chunkCapacity; i < end; ++i) {
+            chunk->EmplaceBack(getter(i));
+        }
+        NodePtr right = _build(getter, count, mid + 1, lastChunk);
+        return _make(left, chunk, right);
+    }
+
+    template <typename Getter>
+    static NodePtr _build(Getter& getter, int count) {
+        return _build(getter, count, 0, (count + chunkCapacity - 1) / chunkCapacity);
+    }
+
+    template <typename Visitor>
+    static bool _visit(const Node* node, Visitor& visitor) {
+        while (node != nullptr) {
+            if (!_visit(node->left.get(), visitor)) {
+                return false;
+            }
+            if (!visitor(node->chunk->begin(), node->chunk->GetSize())) {
+                return false;
+            }
+            node = node->right.get();
+        }
+        return true;
+    }
+
+    void _checkException(int index) const {
+        if (index < 0 || index >= _size(root)) {
+            throw std::out_of_range("Index out of range");
+        }
+    }
+
+    explicit PersistentVector(const NodePtr& node) : root(node) {}
+
+    // Inserts into the run that holds (or ends at) index when it has room, copying only the
+    // path to it. Returns null, without touching value, when that run is full.
+    template <typename U>
+    static NodePtr _insertInRun(const NodePtr& node, int index, U&& value) {
+        int leftSize = _size(node->left);
+        int count = node->chunk->GetSize();
+        if (index < leftSize) {
+            NodePtr left = _insertInRun(node->left, index, std::forward<U>(value));
+            return left ? _make(left, node->chunk, node->right) : nullptr;
+        }
+        if (index > leftSize + count) {
+            NodePtr right = _insertInRun(node->right, index - leftSize - count, std::forward<U>(value));
+            return right ? _make(node->left, node->chunk, right) : nullptr;
+        }
+        if (count == chunkCapacity) {
+            return nullptr;
+        }
+
+        const Chunk& old = *node->chunk;
+        int at = index - leftSize;
+        ChunkPtr chunk = _newChunk(count + 1);
+        for (int i = 0; i < at; ++i) {
+            chunk->EmplaceBack(old.GetUnchecked(i));
+        }
+        chunk->EmplaceBack(std::forward<U>(value));
+        for (int i = at; i < count; ++i) {
+            chunk->EmplaceBack(old.GetUnchecked(i));
+        }
+        return _make(node->left, chunk, node->right);
+    }
+
+    // A full run is cut at index, so the new element joins the shorter half.
+    template <typename U>
+    PersistentVector<T> _insert(U&& value, int index) const {
+        if (index < 0 || index > _size(root)) {
+            throw std::out_of_range("Index out of range");
+        }
+
+        if (root) {
+            if (NodePtr inserted = _insertInRun(root, index, std::forward<U>(value))) {
+                return PersistentVector<T>(inserted);
+            }
+        }
+        auto [l, r] = _split(root, index);
+        return PersistentVector<T>(_concat(_concat(l, _make(nullptr, _single(std::forward<U>(value)), nullptr)), r));
+    }
+
+public:
+    // In-order walk that keeps the root-to-node path and the position inside the node's
+    // run, so a full scan is O(N) overall.
+    class ConstIterator {
+    private:
+        static const int maxDepth = 64;
+
+        const Node* root;
+        const Node* path[maxDepth];
+        int depth;
+        int offset;
+        int index;
+
+        void _pushLeftmost(const Node* node) {
+            while (node != nullptr) {
+                path[depth++] = node;
+                node = node->left.get();
+            }
+        }
+
+        void _pushRightmost(const Node* node) {
+            while (node != nullptr) {
+                path[depth++] = node;
+                node = node->right.get();
+            }
+        }
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        ConstIterator() : root(nullptr), depth(0), offset(0), index(0) {}
+
+        ConstIterator(const Node* root_, int index_) : root(root_), depth(0), offset(0), index(index_) {
+            const Node* current = root;
+            while (current != nullptr && index_ < current->size) {
+                path[depth++] = current;
+                int leftSize = _size(current->left);
+                int count = current->chunk->GetSize();
+                if (index_ < leftSize) {
+                    current = current->left.get();
+                } else if (index_ < leftSize + count) {
+                    offset = index_ - leftSize;
+                    break;
+                } else {
+                    index_ -= leftSize + count;
+                    current = current->right.get();
+                }
+            }
+        }
+
+        reference operator*() const {
+            return path[depth - 1]->chunk->GetUnchecked(offset);
+        }
+
+        pointer operator->() const {
+            return &**this;
+        }
+
+        ConstIterator& operator++() {
+            ++index;
+            const Node* current = path[depth - 1];
+            if (++offset < current->chunk->GetSize()) {
+                return *this;
+            }
+            offset = 0;
+            if (current->right) {
+                _pushLeftmost(current->right.get());
+            } else {
+                --depth;
+                while (depth > 0 && path[depth - 1]->right.get() == current) {
+                    current = path[--depth];
+                }
+            }
+            return *this;
+        }
+
+        ConstIterator operator++(int) {
+            ConstIterator ret = *this;
+            ++(*this);
+            return ret;
+        }
+
+        ConstIterator& operator--() {
+            --index;
+            if (depth > 0 && offset > 0) {
+                --offset;
+                return *this;
+            }
+            if (depth == 0) {
+                _pushRightmost(root);
+            } else {
+                const Node* current = path[depth - 1];
+                if (current->left) {
+                    _pushRightmost(current->left.get());
+                } else {
+                    --depth;
+                    while (depth > 0 && path[depth - 1]->left.get() == current) {
+                        current = path[--depth];
+                    }
+                }
+            }
+            if (depth > 0) {
+                offset = path[depth - 1]->chunk->GetSize() - 1;
+            }
+            return *this;
+        }
+
+        ConstIterator operator--(int) {
+            ConstIterator ret = *this;
+            --(*this);
+            return ret;
+        }
+
+        bool operator==(const ConstIterator& other) const {
+            return index == other.index;
+        }
+
+        bool operator!=(const ConstIterator& other) const {
+            return index != other.index;
+        }
+    };
+
+    PersistentVector() : root(nullptr) {}
+
+    PersistentVector(const T* items, int count) : root(nullptr) {
+        auto getter = [items](int i) -> const T& { return items[i]; };
+        root = _build(getter, count);
+    }
+
+    template <typename Getter>
+    PersistentVector(int count, Getter getter) : root(_build(getter, count)) {}
+
+    // _build fills runs in order, so a forward range is consumed in a single pass.
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    PersistentVector(InputIterator first, InputIterator last) : root(nullptr) {
+        if constexpr (IsForwardIterator<InputIterator>::value) {
+            auto getter = [&first](int) -> T {
+                T value = *first;
+                ++first;
+                return value;
+            };
+            root = _build(getter, static_cast<int>(std::distance(first, last)));
+        } else {
+            ChunkPtr chunk = nullptr;
+            for (; first != last; ++first) {
+                if (chunk != nullptr && chunk->GetSize() == chunkCapacity) {
+                    root = _join(root, chunk, nullptr);
+                    chunk = nullptr;
+                }
+                if (chunk == nullptr) {
+                    chunk = _newChunk(chunkCapacity);
+                }
+                chunk->EmplaceBack(*first);
+            }
+            if (chunk != nullptr) {
+                root = _join(root, chunk, nullptr);
+            }
+        }
+    }
+
+    int GetSize() const {
+        return _size(root);
+    }
+
+    ConstIterator begin() const {
+        return ConstIterator(root.get(), 0);
+    }
+
+    ConstIterator end() const {
+        return ConstIterator(root.get(), GetSize());
+    }
+
+    // Calls visitor(items, count) for each run in order until it returns false.
+    template <typename Visitor>
+    bool VisitChunks(Visitor&& visitor) const {
+        return _visit(root.get(), visitor);
+    }
+
+    const T& Get(int index) const {
+        _checkException(index);
+        return GetUnchecked(index);
+    }
+
+    const T& GetUnchecked(int index) const {
+        const Node* current = root.get();
+        while (true) {
+            int leftSize = _size(current->left);
+            if (index < leftSize) {
+                current = current->left.get();
+                continue;
+            }
+            index -= leftSize;
+            if (index < current->chunk->GetSize()) {
+                return current->chunk->GetUnchecked(index);
+            }
+            index -= current->chunk->GetSize();
+            current = current->right.get();
+        }
+    }
+
+    // Writable access copies every node on the path, and the run it ends in, that is still
+    // shared with another version.
+    T& operator[](int index) {
+        _checkException(index);
+
+        NodePtr* current = &root;
+        while (true) {
+            if (current->use_count() > 1) {
+                Instrument::Allocation(sizeof(Node));
+                *current = std::make_shared<Node>(**current);
+            }
+
+            Node* node = current->get();
+            int leftSize = _size(node->left);
+            if (index < leftSize) {
+                current = &node->left;
+                continue;
+            }
+            index -= leftSize;
+            if (index < node->chunk->GetSize()) {
+                if (node->chunk.use_count() > 1) {
+                    Instrument::Allocation(sizeof(Chunk));
+                    node->chunk = std::make_shared<Chunk>(*node->chunk);
+                }
+                return node->chunk->GetUnchecked(index);
+            }
+            index -= node->chunk->GetSize();
+            current = &node->right;
+        }
+    }
+
+    PersistentVector<T> Append(const T& value) const {
+        return _insert(value, GetSize());
+    }
+
+    PersistentVector<T> Append(T&& value) const {
+        return _insert(std::move(value), GetSize());
+    }
+
+    PersistentVector<T> Prepend(const T& value) const {
+        return _insert(value, 0);
+    }
+
+    PersistentVector<T> Prepend(T&& value) const {
+        return _insert(std::move(value), 0);
+    }
+
+    PersistentVector<T> InsertAt(const T& value, int index) const {
+        return _insert(value, index);
+    }
+
+    PersistentVector<T> InsertAt(T&& value, int index) const {
+        return _insert(std::move(value), index);
+    }
+
+    PersistentVector<T> Concat(const PersistentVector<T>& other) const {
+        return PersistentVector<T>(_concat(root, other.root));
+    }
+
+    PersistentVector<T> RemoveAt(int index) const {
+        return RemoveRange(index, index);
+    }
+
+    PersistentVector<T> RemoveRange(int startIndex, int endIndex) const {
+        _checkException(startIndex);
+        _checkException(endIndex);
+        if (startIndex > endIndex) {
+            throw std::invalid_argument("Invalid range");
+        }
+
+        auto [head, rest] = _split(root, endIndex + 1);
+        return PersistentVector<T>(_concat(_split(head, startIndex).first, rest));
+    }
+
+    template <typename Predicate>
+    PersistentVector<T> RemoveIf(Predicate predicate) const {
+        return PersistentVector<T>(_removeIf(root, predicate));
+    }
+
+    PersistentVector<T> GetSubVector(int startIndex, int endIndex) const {
+        _checkException(startIndex);
+        _checkException(endIndex);
+
+        if (startIndex <= endIndex) {
+            auto [head, rest] = _split(root, endIndex + 1);
+            return PersistentVector<T>(_split(head, startIndex).second);
+        }
+
+        ConstIterator current(root.get(), startIndex);
+        auto getter = [&current](int) -> const T& {
+            const T& value = *current;
+            --current;
+            return value;
+        };
+        return PersistentVector<T>(startIndex - endIndex + 1, getter);
+    }
+};
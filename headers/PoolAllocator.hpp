@@ -0,0 +1,187 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include "Instrumentation.hpp"
+
+
+// Slab allocator for single objects. Slots are carved out of chunks that double in size
+// up to maxChunkSize, freed slots go onto a free list and are reused first, and the whole
+// pool goes back to the system chunk by chunk. Copies of an allocator share its pool;
+// copying a container gives the copy a pool of its own. The pool is created on first use.
+template <typename T>
+class PoolAllocator {
+private:
+    template <typename> friend class PoolAllocator;
+
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    static_assert(alignof(Slot) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "over-aligned types are not supported");
+
+    static const int firstChunkSize = 32;
+    static const int maxChunkSize = 4096;
+
+    // The first slot of every chunk links it to the previously allocated chunk.
+    struct Pool {
+        Slot* chunks = nullptr;
+        Slot* lastChunk = nullptr;
+        Slot* freeList = nullptr;
+        Slot* freeTail = nullptr;
+        Slot* cursor = nullptr;
+        Slot* cursorEnd = nullptr;
+        int nextChunkSize = firstChunkSize;
+
+        ~Pool() {
+            Release();
+        }
+
+        void Release() {
+            while (chunks != nullptr) {
+                Slot* next = chunks->next;
+                ::operator delete(chunks);
+                chunks = next;
+            }
+            lastChunk = freeList = freeTail = cursor = cursorEnd = nullptr;
+            nextChunkSize = firstChunkSize;
+        }
+
+        Slot* Take() {
+            if (freeList != nullptr) {
+                Slot* slot = freeList;
+                freeList = slot->next;
+                if (freeList == nullptr) freeTail = nullptr;
+                return slot;
+            }
+
+            if (cursor == cursorEnd) {
+                Instrument::Allocation(static_cast<long long>(sizeof(Slot)) * (nextChunkSize + 1));
+                Slot* chunk = static_cast<Slot*>(::operator new(sizeof(Slot) * (nextChunkSize + 1)));
+                chunk->next = chunks;
+                if (chunks == nullptr) lastChunk = chunk;
+                chunks = chunk;
+                cursor = chunk + 1;
+                cursorEnd = cursor + nextChunkSize;
+                if (nextChunkSize < maxChunkSize) nextChunkSize *= 2;
+            }
+            return cursor++;
+        }
+
+        void Give(Slot* slot) {
+            slot->next = freeList;
+            if (freeList == nullptr) freeTail = slot;
+            freeList = slot;
+        }
+
+        // Takes over the chunks and free slots of other in O(1); its unused bump range is dropped.
+        void Absorb(Pool& other) {
+            if (other.chunks != nullptr) {
+                other.lastChunk->next = chunks;
+                if (chunks == nullptr) lastChunk = other.lastChunk;
+                chunks = other.chunks;
+            }
+            if (other.freeList != nullptr) {
+                other.freeTail->next = freeList;
+                if (freeList == nullptr) freeTail = other.freeTail;
+                freeList = other.freeList;
+            }
+            other.chunks = other.lastChunk = other.freeList = other.freeTail = nullptr;
+            other.cursor = other.cursorEnd = nullptr;
+        }
+    };
+
+    std::shared_ptr<Pool> pool;
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    PoolAllocator() : pool() {}
+
+    PoolAllocator(const PoolAllocator& other) = default;
+
+    // The moved-from allocator stays usable and starts a new pool when it next allocates.
+    PoolAllocator(PoolAllocator&& other) noexcept = default;
+
+    PoolAllocator& operator=(const PoolAllocator& other) = default;
+    PoolAllocator& operator=(PoolAllocator&& other) noexcept = default;
+
+    // A rebound allocator serves a different slot size, so it starts its own pool.
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) : pool() {}
+
+    PoolAllocator select_on_container_copy_construction() const {
+        return PoolAllocator();
+    }
+
+    T* allocate(std::size_t count) {
+        if (count != 1) {
+            return std::allocator<T>().allocate(count);
+        }
+        if (!pool) {
+            pool = std::make_shared<Pool>();
+        }
+        return reinterpret_cast<T*>(pool->Take()->storage);
+    }
+
+    void deallocate(T* pointer, std::size_t count) {
+        if (count != 1) {
+            std::allocator<T>().deallocate(pointer, count);
+            return;
+        }
+        pool->Give(reinterpret_cast<Slot*>(pointer));
+    }
+
+    // Frees every chunk at once. Only allowed while no other allocator shares the pool,
+    // and every object taken from it must already be dead or trivially destructible.
+    bool Release() {
+        if (!pool) {
+            return true;
+        }
+        if (pool.use_count() != 1) {
+            return false;
+        }
+        pool->Release();
+        return true;
+    }
+
+    // Moves every chunk of other's pool into this one and makes other share it, so objects
+    // can pass between containers that use the two allocators. Fails if other's pool is shared.
+    bool Merge(PoolAllocator& other) {
+        if (!pool) {
+            pool = std::make_shared<Pool>();
+        }
+        if (pool == other.pool) {
+            return true;
+        }
+        if (other.pool) {
+            if (other.pool.use_count() != 1) {
+                return false;
+            }
+            pool->Absorb(*other.pool);
+        }
+        other.pool = pool;
+        return true;
+    }
+
+    bool operator==(const PoolAllocator& other) const {
+        return pool == other.pool;
+    }
+
+    bool operator!=(const PoolAllocator& other) const {
+        return pool != other.pool;
+    }
+};
+
+
+template <typename Allocator>
+struct IsPoolAllocator : std::false_type {};
+
+template <typename T>
+struct IsPoolAllocator<PoolAllocator<T>> : std::true_type {};
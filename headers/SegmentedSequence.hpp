@@ -1,5 +1,8 @@
 #pragma once
 #include <stdexcept>
+#include <iterator>
+#include <type_traits>
+#include <initializer_list>
 #include "Sequence.hpp"
 
 
@@ -18,22 +21,84 @@ private:
     int segmentSize;
     int totalSize;
 
+    // A segment shorter than lowWatermark * segmentSize is merged into a neighbour when the
+    // two fit in one segment; Compact packs segments to fillFactor * segmentSize.
+    double lowWatermark;
+    double fillFactor;
+
+    // Fenwick tree over segment lengths (1-based), rebuilt whenever the segment list changes shape.
+    DynamicArray<int> lengthIndex;
+    int lengthIndexStep;
+
+    void rebuildLengthIndex() {
+        int count = segments->GetLength();
+        lengthIndex.Resize(count + 1);
+        lengthIndex[0] = 0;
+        for (int i = 1; i <= count; ++i) {
+            lengthIndex[i] = segments->Get(i - 1)->GetLength();
+        }
+        for (int i = 1; i <= count; ++i) {
+            int parent = i + (i & -i);
+            if (parent <= count) {
+                lengthIndex[parent] += lengthIndex[i];
+            }
+        }
+
+        lengthIndexStep = 1;
+        while (lengthIndexStep * 2 <= count) lengthIndexStep <<= 1;
+    }
+
+    void updateLengthIndex(int segmentIndex, int delta) {
+        int count = segments->GetLength();
+        for (int i = segmentIndex + 1; i <= count; i += i & -i) {
+            lengthIndex[i] += delta;
+        }
+    }
+
+    void appendLengthIndex(int length) {
+        int count = segments->GetLength();
+        lengthIndex.Resize(count + 1);
+        lengthIndex[count] = length;
+        for (int i = count - 1, stop = count - (count & -count); i > stop; i -= i & -i) {
+            lengthIndex[count] += lengthIndex[i];
+        }
+
+        while (lengthIndexStep * 2 <= count) lengthIndexStep <<= 1;
+    }
+
+    // Descends the length index to the segment holding index; index is turned into the
+    // offset inside it. Nothing is checked, so index must be in [0, totalSize).
+    int findSegment(int& index, bool isAdded=0) const {
+        int target = isAdded ? index : index + 1;
+        int count = segments->GetLength();
+        int ind = 0;
+        for (int step = lengthIndexStep; step > 0; step >>= 1) {
+            int next = ind + step;
+            if (next <= count) {
+                int length = lengthIndex.GetUnchecked(next);
+                if (length < target) {
+                    ind = next;
+                    target -= length;
+                    index -= length;
+                }
+            }
+        }
+        return ind;
+    }
+
     std::tuple<SegmentSequence<T>*, int, int> getSegmentAndOffset(int index, bool isAdded=0) const {
         if (index < 0 || index >= totalSize || segments->GetLength() == 0) {
             throw std::out_of_range("Index out of range");
         }
-    
-        int ind = 0;
-        while (ind < segments->GetLength() && index >= segments->Get(ind)->GetLength() + isAdded) {
-            index -= segments->Get(ind)->GetLength();
-            ++ind;
-        }
-    
+
+        int ind = findSegment(index, isAdded);
         if (ind >= segments->GetLength()) {
             throw std::out_of_range("Index out of range");
         }
-    
-        return std::make_tuple(segments->Get(ind), ind, index);
+
+        // Const lookups on the container, so a list container's finger is left alone.
+        const auto* container = this->segments;
+        return std::make_tuple(container->GetUnchecked(ind), ind, index);
     }
 
     void ensureCapacity(int requiredCapacity) {
@@ -52,6 +117,7 @@ private:
             throw std::out_of_range("Invalid segment index");
         }
     
+        Instrument::SegmentSplit();
         Sequence<T>* oldSegment = segments->Get(segmentIndex);
         int segmentLength = oldSegment->GetLength();
     
@@ -62,143 +128,621 @@ private:
         }
     
         SegmentSequence<T>* newSegment = createSegment();
-        SegmentSequence<T>* firstPart = static_cast<SegmentSequence<T>*>(oldSegment->GetSubsequence(0, splitPos-1));
+        SegmentSequence<T>* firstPart = createSegment();
 
-        for (int i = splitPos; i < oldSegment->GetLength(); ++i) {
-            newSegment->Append(oldSegment->Get(i));
+        int position = 0;
+        for (T& item : *static_cast<SegmentSequence<T>*>(oldSegment)) {
+            if (position++ < splitPos) {
+                firstPart->Append(std::move_if_noexcept(item));
+            } else {
+                newSegment->Append(std::move_if_noexcept(item));
+            }
         }
 
         segments->Get(segmentIndex) = firstPart;
         if (segmentIndex + 1 == segments->GetLength()) {
+            updateLengthIndex(segmentIndex, firstPart->GetLength() - segmentLength);
             segments->Append(newSegment);
+            appendLengthIndex(newSegment->GetLength());
         } else {
             segments->InsertAt(newSegment, segmentIndex + 1);
+            rebuildLengthIndex();
         }
         
         delete oldSegment;
     }
 
-    virtual Sequence<T>* AppendInternal(const T& item) override {
+    // Bulk helpers leave the length index stale; callers rebuild it once at the end.
+    void appendSegment(SegmentSequence<T>* segment) {
+        segments->Append(segment);
+        totalSize += segment->GetLength();
+    }
+
+    // Tops up the last segment, then builds full segments straight from the range.
+    void appendRange(const T* items, int count) {
+        if (count > 0 && segments->GetLength() > 0) {
+            SegmentSequence<T>* last = segments->GetLast();
+            int room = std::max(0, std::min(segmentSize - last->GetLength(), count));
+            for (int i = 0; i < room; ++i) {
+                last->Append(items[i]);
+            }
+            items += room;
+            count -= room;
+            totalSize += room;
+        }
+
+        while (count > 0) {
+            int length = std::min(segmentSize, count);
+            appendSegment(new SegmentSequence<T>(items, length));
+            items += length;
+            count -= length;
+        }
+    }
+
+    // Fills the last segment up to segmentSize before starting the next one.
+    template <typename InputIterator>
+    void appendItems(InputIterator first, InputIterator last) {
+        SegmentSequence<T>* current = segments->GetLength() == 0 ? nullptr : segments->GetLast();
+        for (; first != last; ++first) {
+            if (current == nullptr || current->GetLength() >= segmentSize) {
+                current = createSegment();
+                appendSegment(current);
+            }
+            current->Append(*first);
+            ++totalSize;
+        }
+    }
+
+    void copySegmentsFrom(const SegmentedSequence& other) {
+        const auto* container = other.segments;
+        int count = container->GetLength();
+        for (int i = 0; i < count; ++i) {
+            const SegmentSequence<T>* segment = container->GetUnchecked(i);
+            if (segment->GetLength() == 0) {
+                continue;
+            }
+            if (segment->GetLength() <= segmentSize) {
+                appendSegment(new SegmentSequence<T>(*segment));
+            } else {
+                segment->ForEachChunk([this](const T* items, int length) {
+                    appendRange(items, length);
+                    return true;
+                });
+            }
+        }
+        rebuildLengthIndex();
+    }
+
+    // Replaces the segment container with one holding only [first, last); the segments
+    // themselves are neither copied nor freed.
+    void keepSegments(int first, int last) {
+        int count = segments->GetLength();
+        if (last < count) {
+            segments->RemoveRange(last, count - 1);
+        }
+        if (first > 0) {
+            segments->RemoveRange(0, first - 1);
+        }
+    }
+
+    // Frees the segments [first, last) and drops them from the container.
+    void eraseSegments(int first, int last) {
+        if (first >= last) {
+            return;
+        }
+        for (int i = first; i < last; ++i) {
+            delete segments->GetUnchecked(i);
+        }
+        segments->RemoveRange(first, last - 1);
+    }
+
+    void eraseSegment(int segmentIndex) {
+        eraseSegments(segmentIndex, segmentIndex + 1);
+    }
+
+    // Moves the elements of the segment after segmentIndex into it and drops the emptied segment.
+    void mergeWithNext(int segmentIndex) {
+        SegmentSequence<T>* left = segments->Get(segmentIndex);
+        for (T& item : *segments->Get(segmentIndex + 1)) {
+            left->Append(std::move_if_noexcept(item));
+        }
+        eraseSegment(segmentIndex + 1);
+    }
+
+    // Drops an empty segment, or merges one below the low watermark into its shorter neighbour.
+    void rebalanceSegment(int segmentIndex) {
+        int count = segments->GetLength();
+        if (segmentIndex < 0 || segmentIndex >= count) {
+            return;
+        }
+
+        int length = segments->Get(segmentIndex)->GetLength();
+        if (length == 0) {
+            eraseSegment(segmentIndex);
+            rebuildLengthIndex();
+            return;
+        }
+        if (length >= segmentSize * lowWatermark) {
+            return;
+        }
+
+        int previous = segmentIndex > 0 ? segments->Get(segmentIndex - 1)->GetLength() : segmentSize;
+        int next = segmentIndex + 1 < count ? segments->Get(segmentIndex + 1)->GetLength() : segmentSize;
+        if (segmentIndex > 0 && previous <= next && length + previous <= segmentSize) {
+            mergeWithNext(segmentIndex - 1);
+        } else if (segmentIndex + 1 < count && length + next <= segmentSize) {
+            mergeWithNext(segmentIndex);
+        } else {
+            return;
+        }
+        rebuildLengthIndex();
+    }
+
+    // Starts a segment holding only the item. Appends and prepends use it when the edge segment
+    // is full, so they leave full segments behind; so does a full one-element segment, which
+    // can't be split.
+    Sequence<T>* insertSegmentWith(T&& item, int position) {
+        SegmentSequence<T>* segment = createSegment();
+        segment->Append(std::move(item));
+        totalSize++;
+        if (position == segments->GetLength()) {
+            segments->Append(segment);
+            appendLengthIndex(1);
+            return this;
+        }
+
+        if (position == 0) {
+            segments->Prepend(segment);
+        } else {
+            segments->InsertAt(segment, position);
+        }
+        rebuildLengthIndex();
+        return this;
+    }
+
+    // Whole segments inside the range are dropped without touching their elements; the
+    // segments at the two ends shrink and may then merge with a neighbour.
+    void removeRange(int startIndex, int endIndex) {
+        auto [segment, segmentIndex, offset] = getSegmentAndOffset(startIndex);
+        int left = endIndex - startIndex + 1;
+        int dropFirst = -1;
+        int dropLast = -1;
+        for (int i = segmentIndex; left > 0; ++i) {
+            SegmentSequence<T>* current = segments->GetUnchecked(i);
+            int count = std::min(current->GetLength() - offset, left);
+            if (count == current->GetLength()) {
+                if (dropFirst < 0) dropFirst = i;
+                dropLast = i + 1;
+            } else if (count > 0) {
+                current->RemoveRange(offset, offset + count - 1);
+                updateLengthIndex(i, -count);
+            }
+            left -= count;
+            offset = 0;
+        }
+
+        totalSize -= endIndex - startIndex + 1;
+        if (dropFirst >= 0) {
+            eraseSegments(dropFirst, dropLast);
+            rebuildLengthIndex();
+        }
+        rebalanceSegment(segmentIndex + 1);
+        rebalanceSegment(segmentIndex);
+        rebalanceSegment(segmentIndex - 1);
+    }
+
+    // Items arrive owned: a split may move the element an lvalue argument refers to.
+    Sequence<T>* appendItem(T&& item) {
         if (this->segments->GetLength() == 0) {
             this->segments->Append(createSegment());
+            appendLengthIndex(0);
         }
 
         if (this->segments->GetLast()->GetLength() >= segmentSize) {
-            splitSegment(this->GetSegmentsLength() - 1);
-            return AppendInternal(item);
+            return insertSegmentWith(std::move(item), this->segments->GetLength());
         }
 
-        this->segments->GetLast()->Append(item);
+        this->segments->GetLast()->Append(std::move(item));
+        updateLengthIndex(this->segments->GetLength() - 1, 1);
         totalSize++;
         return this;
     }
 
-    virtual Sequence<T>* PrependInternal(const T& item) override {
+    Sequence<T>* prependItem(T&& item) {
         if (this->segments->GetLength() == 0) {
             segments->Prepend(createSegment());
+            rebuildLengthIndex();
         }
 
         if (this->segments->GetFirst()->GetLength() >= segmentSize) {
-            splitSegment(0);
-            return PrependInternal(item);
+            return insertSegmentWith(std::move(item), 0);
         }
 
-        this->segments->GetFirst()->Prepend(item);
+        this->segments->GetFirst()->Prepend(std::move(item));
+        updateLengthIndex(0, 1);
         totalSize++;
         return this;
     }
 
-    virtual Sequence<T>* InsertAtInternal(const T& item, int globalIndex) override {
+    Sequence<T>* insertItem(T&& item, int globalIndex) {
         if (globalIndex < 0 || globalIndex > totalSize) {
             throw std::out_of_range("Global index out of range");
         }
     
         if (globalIndex == totalSize) {
-            return AppendInternal(item);
+            return appendItem(std::move(item));
         }
         if (globalIndex == 0) {
-            return PrependInternal(item);
+            return prependItem(std::move(item));
         }
     
         auto [segment, segmentIndex, localIndex] = getSegmentAndOffset(globalIndex, 1);
         if (segment->GetLength() >= segmentSize) {
+            if (segment->GetLength() < 2) {
+                return insertSegmentWith(std::move(item), localIndex == 0 ? segmentIndex : segmentIndex + 1);
+            }
             splitSegment(segmentIndex);
-            return InsertAtInternal(item, globalIndex);
+            return insertItem(std::move(item), globalIndex);
         }
         
         if (localIndex == segment->GetLength()) {
-            segment->Append(item);
+            segment->Append(std::move(item));
         } else if (localIndex == 0) {
-            segment->Prepend(item);
+            segment->Prepend(std::move(item));
         } else {
-            segment->InsertAt(item, localIndex);
+            segment->InsertAt(std::move(item), localIndex);
         }
 
+        updateLengthIndex(segmentIndex, 1);
         totalSize++;
         return this;
     }
 
-    virtual Sequence<T>*ConcatInternal(const Sequence<T>* other) override {
-        for (int i = 0; i < other->GetLength(); ++i) {
-            this->Append(other->Get(i));
+    virtual Sequence<T>* AppendInternal(const T& item) override {
+        return appendItem(T(item));
+    }
+
+    virtual Sequence<T>* AppendInternal(T&& item) override {
+        return appendItem(std::move(item));
+    }
+
+    virtual Sequence<T>* PrependInternal(const T& item) override {
+        return prependItem(T(item));
+    }
+
+    virtual Sequence<T>* PrependInternal(T&& item) override {
+        return prependItem(std::move(item));
+    }
+
+    virtual Sequence<T>* InsertAtInternal(const T& item, int globalIndex) override {
+        return insertItem(T(item), globalIndex);
+    }
+
+    virtual Sequence<T>* InsertAtInternal(T&& item, int globalIndex) override {
+        return insertItem(std::move(item), globalIndex);
+    }
+
+    // Another segmented sequence is copied segment by segment; anything else chunk by chunk.
+    virtual Sequence<T>* ConcatInternal(const Sequence<T>* other) override {
+        if (auto* segmented = dynamic_cast<const SegmentedSequence*>(other)) {
+            int junction = segments->GetLength() - 1;
+            copySegmentsFrom(*segmented);
+            rebalanceSegment(junction + 1);
+            rebalanceSegment(junction);
+            return this;
+        }
+
+        other->ForEachChunk([this](const T* items, int count) {
+            appendRange(items, count);
+            return true;
+        });
+        rebuildLengthIndex();
+        return this;
+    }
+
+    virtual Sequence<T>* RemoveAtInternal(int index) override {
+        removeRange(index, index);
+        return this;
+    }
+
+    virtual Sequence<T>* RemoveRangeInternal(int startIndex, int endIndex) override {
+        removeRange(startIndex, endIndex);
+        return this;
+    }
+
+    // Filters every segment in place, then drops the empty ones and merges runs of short
+    // neighbours in a single pass.
+    virtual Sequence<T>* RemoveIfInternal(const std::function<bool(const T&)>& predicate) override {
+        int count = segments->GetLength();
+        auto* kept = new ContainerSequence<SegmentSequence<T>*>();
+        SegmentSequence<T>* last = nullptr;
+        totalSize = 0;
+        for (int i = 0; i < count; ++i) {
+            SegmentSequence<T>* segment = segments->GetUnchecked(i);
+            segment->RemoveIf(predicate);
+            int length = segment->GetLength();
+            totalSize += length;
+            if (length == 0) {
+                delete segment;
+                continue;
+            }
+
+            bool sparse = std::min(length, last == nullptr ? 0 : last->GetLength()) < segmentSize * lowWatermark;
+            if (last != nullptr && sparse && last->GetLength() + length <= segmentSize) {
+                for (T& item : *segment) {
+                    last->Append(std::move_if_noexcept(item));
+                }
+                delete segment;
+            } else {
+                kept->Append(segment);
+                last = segment;
+            }
         }
+
+        delete segments;
+        segments = kept;
+        rebuildLengthIndex();
         return this;
     }
 
 protected:
+    // Moves every segment of other to the end of this sequence without touching the elements.
+    // Segments keep their length, so one longer than segmentSize is split on its next insert.
+    void relinkSegments(SegmentedSequence& other) {
+        if (&other == this) {
+            throw std::invalid_argument("Cannot move a sequence into itself");
+        }
+
+        int junction = segments->GetLength() - 1;
+        int count = other.segments->GetLength();
+        for (int i = 0; i < count; ++i) {
+            segments->Append(other.segments->GetUnchecked(i));
+        }
+        totalSize += other.totalSize;
+        other.keepSegments(0, 0);
+        other.totalSize = 0;
+        rebuildLengthIndex();
+        other.rebuildLengthIndex();
+        rebalanceSegment(junction + 1);
+        rebalanceSegment(junction);
+    }
+
+    // Moves [index, length) into rest, which must be empty. Only the segment holding index is split.
+    void splitSegmentsAt(int index, SegmentedSequence& rest) {
+        if (index < 0 || index > totalSize) {
+            throw std::out_of_range("Split index out of range");
+        }
+        if (index == totalSize) {
+            return;
+        }
+
+        auto [segment, segmentIndex, localIndex] = getSegmentAndOffset(index);
+        if (localIndex > 0) {
+            splitSegment(segmentIndex, localIndex);
+            ++segmentIndex;
+        }
+
+        int count = segments->GetLength();
+        for (int i = segmentIndex; i < count; ++i) {
+            rest.appendSegment(segments->GetUnchecked(i));
+        }
+        keepSegments(0, segmentIndex);
+        totalSize = index;
+        rebuildLengthIndex();
+        rest.rebuildLengthIndex();
+        rebalanceSegment(segmentIndex - 1);
+        rest.rebalanceSegment(0);
+    }
+
     virtual Sequence<T>* Instance() = 0;
     virtual SegmentedSequence<T, SegmentSequence, ContainerSequence>* CreateEmptySegSequence() const = 0;
 
 public:
+    // Walks the segment container and each segment with their own iterators.
+    template <bool IsConst>
+    class SegmentIterator {
+    private:
+        using SegmentType = std::conditional_t<IsConst, const SegmentSequence<T>, SegmentSequence<T>>;
+        using OuterIterator = decltype(std::declval<const ContainerSequence<SegmentSequence<T>*>&>().begin());
+        using InnerIterator = decltype(std::declval<SegmentType&>().begin());
+
+        template <bool> friend class SegmentIterator;
+
+        OuterIterator outer;
+        OuterIterator outerBegin;
+        OuterIterator outerEnd;
+        InnerIterator inner;
+
+        void _skipEmpty() {
+            while (outer != outerEnd && inner == static_cast<SegmentType*>(*outer)->end()) {
+                ++outer;
+                if (outer != outerEnd) {
+                    inner = static_cast<SegmentType*>(*outer)->begin();
+                }
+            }
+        }
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+
+        SegmentIterator() : outer(), outerBegin(), outerEnd(), inner() {}
+
+        SegmentIterator(OuterIterator position, OuterIterator begin_, OuterIterator end_)
+            : outer(position), outerBegin(begin_), outerEnd(end_), inner() {
+            if (outer != outerEnd) {
+                inner = static_cast<SegmentType*>(*outer)->begin();
+                _skipEmpty();
+            }
+        }
+
+        template <bool WasConst, typename = std::enable_if_t<IsConst && !WasConst>>
+        SegmentIterator(const SegmentIterator<WasConst>& other)
+            : outer(other.outer), outerBegin(other.outerBegin), outerEnd(other.outerEnd), inner(other.inner) {}
+
+        reference operator*() const {
+            return *inner;
+        }
+
+        pointer operator->() const {
+            return &*inner;
+        }
+
+        SegmentIterator& operator++() {
+            ++inner;
+            _skipEmpty();
+            return *this;
+        }
+
+        SegmentIterator operator++(int) {
+            SegmentIterator ret = *this;
+            ++(*this);
+            return ret;
+        }
+
+        SegmentIterator& operator--() {
+            if (outer == outerEnd || inner == static_cast<SegmentType*>(*outer)->begin()) {
+                do {
+                    --outer;
+                    inner = static_cast<SegmentType*>(*outer)->end();
+                } while (inner == static_cast<SegmentType*>(*outer)->begin());
+            }
+            --inner;
+            return *this;
+        }
+
+        SegmentIterator operator--(int) {
+            SegmentIterator ret = *this;
+            --(*this);
+            return ret;
+        }
+
+        bool operator==(const SegmentIterator& other) const {
+            return outer == other.outer && (outer == outerEnd || inner == other.inner);
+        }
+
+        bool operator!=(const SegmentIterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+    using Iterator = SegmentIterator<false>;
+    using ConstIterator = SegmentIterator<true>;
+
+    Iterator begin() {
+        const auto* container = this->segments;
+        return Iterator(container->begin(), container->begin(), container->end());
+    }
+
+    Iterator end() {
+        const auto* container = this->segments;
+        return Iterator(container->end(), container->begin(), container->end());
+    }
+
+    ConstIterator begin() const {
+        const auto* container = this->segments;
+        return ConstIterator(container->begin(), container->begin(), container->end());
+    }
+
+    ConstIterator end() const {
+        const auto* container = this->segments;
+        return ConstIterator(container->end(), container->begin(), container->end());
+    }
+
+    // Segments are walked through their concrete type, so no call in the loop is virtual.
+    template <typename Visitor>
+    bool VisitChunks(Visitor&& visitor) const {
+        for (const SegmentSequence<T>* segment : *static_cast<const ContainerSequence<SegmentSequence<T>*>*>(this->segments)) {
+            if (!segment->VisitChunks(visitor)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool ForEachChunk(const std::function<bool(const T*, int)>& visitor) const override {
+        return this->VisitChunks(visitor);
+    }
+
     explicit SegmentedSequence(int segmentSize_) :
         segments(new ContainerSequence<SegmentSequence<T>*>()),
         segmentSize(segmentSize_),
-        totalSize(0) {
+        totalSize(0),
+        lowWatermark(0.25),
+        fillFactor(1.0) {
         if (segmentSize_ <= 0) {
             throw std::invalid_argument("Segment size must be positive");
         }
+        rebuildLengthIndex();
     }
 
     SegmentedSequence(const T* items, int count, int segmentSize_ = 10) : 
     segments(new ContainerSequence<SegmentSequence<T>*>()),
     segmentSize(segmentSize_),
-    totalSize(0)
+    totalSize(0),
+    lowWatermark(0.25),
+    fillFactor(1.0)
     {
         if (segmentSize_ <= 0) throw std::invalid_argument("Segment size must be positive");
 
-        for (int i = 0; i < count; ++i) {
-            AppendInternal(items[i]);
-        }
+        appendRange(items, count);
+        rebuildLengthIndex();
     }
 
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    SegmentedSequence(InputIterator first, InputIterator last, int segmentSize_ = 10) : 
+    segments(new ContainerSequence<SegmentSequence<T>*>()),
+    segmentSize(segmentSize_),
+    totalSize(0),
+    lowWatermark(0.25),
+    fillFactor(1.0)
+    {
+        if (segmentSize_ <= 0) throw std::invalid_argument("Segment size must be positive");
+
+        appendItems(first, last);
+        rebuildLengthIndex();
+    }
+
+    SegmentedSequence(std::initializer_list<T> items, int segmentSize_ = 10) : 
+        SegmentedSequence(items.begin(), static_cast<int>(items.size()), segmentSize_) {}
+
     SegmentedSequence(const Sequence<T>& other, int segmentSize_ = 10) : 
-    segments(new ContainerSequence<Sequence<T>*>()),
+    segments(new ContainerSequence<SegmentSequence<T>*>()),
     segmentSize(segmentSize_),
-    totalSize(0)
+    totalSize(0),
+    lowWatermark(0.25),
+    fillFactor(1.0)
     {
         if (segmentSize_ <= 0) throw std::invalid_argument("Segment size must be positive");
 
-        for (int i = 0; i < other.GetLength(); ++i) {
-            AppendInternal(other.Get(i));
-        }
+        other.ForEachChunk([this](const T* items, int count) {
+            appendRange(items, count);
+            return true;
+        });
+        rebuildLengthIndex();
     }
 
     SegmentedSequence(const SegmentedSequence& other) : 
     segments(new ContainerSequence<SegmentSequence<T>*>()),
     segmentSize(other.segmentSize),
-    totalSize(0)
+    totalSize(0),
+    lowWatermark(other.lowWatermark),
+    fillFactor(other.fillFactor)
     {
-        for (int i = 0; i < other.segments->GetLength(); ++i) {
-            SegmentSequence<T>* newSegment = static_cast<SegmentSequence<T>*>(other.segments->Get(i)->GetSubsequence(0, other.segments->Get(i)->GetLength()-1));
-            segments->Append(newSegment);
-        }
-        totalSize = other.totalSize;
+        copySegmentsFrom(other);
     }
 
     SegmentedSequence(SegmentedSequence&& other) noexcept :
     segments(other.segments),
     segmentSize(other.segmentSize),
-    totalSize(other.totalSize)
+    totalSize(other.totalSize),
+    lowWatermark(other.lowWatermark),
+    fillFactor(other.fillFactor),
+    lengthIndex(other.lengthIndex),
+    lengthIndexStep(other.lengthIndexStep)
     {
         other.segments = nullptr;
         other.totalSize = 0;
@@ -207,19 +751,16 @@ public:
     SegmentedSequence& operator=(const SegmentedSequence& other) {
         if (this != &other) {
             for (int i = 0; i < segments->GetLength(); ++i) {
-                delete segments->Get(i);
+                delete segments->GetUnchecked(i);
             }
             delete segments;
 
-            segments = new ContainerSequence<Sequence<T>*>();
+            segments = new ContainerSequence<SegmentSequence<T>*>();
             segmentSize = other.segmentSize;
             totalSize = 0;
-
-            for (int i = 0; i < other.segments->GetLength(); ++i) {
-                Sequence<T>* newSegment = other.segments->Get(i)->GetSubsequence(0, other.segments->Get(i)->GetLength()-1);
-                segments->Append(newSegment);
-            }
-            totalSize = other.totalSize;
+            lowWatermark = other.lowWatermark;
+            fillFactor = other.fillFactor;
+            copySegmentsFrom(other);
         }
         return *this;
     }
@@ -227,13 +768,16 @@ public:
     SegmentedSequence& operator=(SegmentedSequence&& other) noexcept {
         if (this != &other) {
             for (int i = 0; i < segments->GetLength(); ++i) {
-                delete segments->Get(i);
+                delete segments->GetUnchecked(i);
             }
             delete segments;
 
             segments = other.segments;
             segmentSize = other.segmentSize;
             totalSize = other.totalSize;
+            lowWatermark = other.lowWatermark;
+            fillFactor = other.fillFactor;
+            rebuildLengthIndex();
 
             other.segments = nullptr;
             other.totalSize = 0;
@@ -242,8 +786,9 @@ public:
     }
 
     ~SegmentedSequence() override {
+        if (this->segments == nullptr) return;
         for (int i = 0; i < this->segments->GetLength(); ++i) {
-            delete this->segments->Get(i);
+            delete this->segments->GetUnchecked(i);
         }
         delete this->segments;
     }
@@ -253,15 +798,41 @@ public:
             throw std::out_of_range("Invalid subsequence range");
         }
 
+        // Each segment in range contributes its own (possibly reversed) subsequence, so only
+        // the two boundary segments are cut and the interior is copied a segment at a time.
         auto* result = this->CreateEmptySegSequence();
-        for (int i = std::min(startIndex, endIndex); i <= std::max(startIndex, endIndex); ++i) {
-            if (startIndex < endIndex) {
-                result->Append(this->Get(i));
-            } else {
-                result->Prepend(this->Get(i));
+        int low = std::min(startIndex, endIndex);
+        int high = std::max(startIndex, endIndex);
+        auto [first, firstIndex, offset] = getSegmentAndOffset(low);
+        auto [last, lastIndex, lastOffset] = getSegmentAndOffset(high);
+
+        DynamicArray<SegmentSequence<T>*> parts;
+        parts.Reserve(lastIndex - firstIndex + 1);
+        const auto* container = this->segments;
+        for (int i = firstIndex; i <= lastIndex; ++i) {
+            const SegmentSequence<T>* segment = container->GetUnchecked(i);
+            int from = i == firstIndex ? offset : 0;
+            int to = i == lastIndex ? lastOffset : segment->GetLength() - 1;
+            if (from > to) {
+                continue;
             }
+            Sequence<T>* part = startIndex <= endIndex ? segment->GetSubsequence(from, to) : segment->GetSubsequence(to, from);
+            parts.EmplaceBack(static_cast<SegmentSequence<T>*>(part));
         }
 
+        if (startIndex <= endIndex) {
+            for (SegmentSequence<T>* part : parts) {
+                result->appendSegment(part);
+            }
+        } else {
+            for (int i = parts.GetSize() - 1; i >= 0; --i) {
+                result->appendSegment(parts[i]);
+            }
+        }
+        result->rebuildLengthIndex();
+        result->rebalanceSegment(result->segments->GetLength() - 1);
+        result->rebalanceSegment(0);
+
         return result;
     }
 
@@ -285,9 +856,15 @@ public:
         if (index < 0 || index >= totalSize) {
             throw std::out_of_range("Index out of range");
         }
-        
-        auto [segment, segmentIndex, localIndex] = getSegmentAndOffset(index);
-        return segment->Get(localIndex);
+
+        return this->GetUnchecked(index);
+    }
+
+    virtual const T& GetUnchecked(int index) const override {
+        int segmentIndex = findSegment(index);
+        const auto* container = this->segments;
+        const SegmentSequence<T>* segment = container->GetUnchecked(segmentIndex);
+        return segment->GetUnchecked(index);
     }
 
     virtual T& GetFirst() override {
@@ -303,8 +880,16 @@ public:
     }
 
     virtual T& Get(int index) override {
-        auto [segment, segmentIndex, localIndex] = getSegmentAndOffset(index);
-        return segment->Get(localIndex);
+        if (index < 0 || index >= totalSize) {
+            throw std::out_of_range("Index out of range");
+        }
+
+        return this->GetUnchecked(index);
+    }
+
+    virtual T& GetUnchecked(int index) override {
+        int segmentIndex = findSegment(index);
+        return segments->GetUnchecked(segmentIndex)->GetUnchecked(index);
     }
 
     virtual int GetLength() const override {
@@ -315,18 +900,48 @@ public:
         return this->Instance()->AppendInternal(item);
     }
 
+    virtual Sequence<T>* Append(T&& item) override {
+        return this->Instance()->AppendInternal(std::move(item));
+    }
+
     virtual Sequence<T>* Prepend(const T& item) override {
         return this->Instance()->PrependInternal(item);
     }
 
+    virtual Sequence<T>* Prepend(T&& item) override {
+        return this->Instance()->PrependInternal(std::move(item));
+    }
+
     virtual Sequence<T>* InsertAt(const T& item, int index) override {
         return this->Instance()->InsertAtInternal(item, index);
     }
 
+    virtual Sequence<T>* InsertAt(T&& item, int index) override {
+        return this->Instance()->InsertAtInternal(std::move(item), index);
+    }
+
     virtual Sequence<T>* Concat(const Sequence<T>* other) override {
         return this->Instance()->ConcatInternal(other);
     }
 
+    virtual Sequence<T>* RemoveAt(int index) override {
+        if (index < 0 || index >= totalSize) {
+            throw std::out_of_range("Index out of range");
+        }
+        return this->Instance()->RemoveAtInternal(index);
+    }
+
+    virtual Sequence<T>* RemoveRange(int startIndex, int endIndex) override {
+        if (std::min(startIndex, endIndex) < 0 || std::max(startIndex, endIndex) >= totalSize) {
+            throw std::out_of_range("Invalid range");
+        }
+        return this->Instance()->RemoveRangeInternal(std::min(startIndex, endIndex), std::max(startIndex, endIndex));
+    }
+
+    virtual Sequence<T>* RemoveIf(const std::function<bool(const T&)>& predicate) override {
+        return this->Instance()->RemoveIfInternal(predicate);
+    }
+
     Sequence<T>* GetSegment(int idx) {
         return this->segments->Get(idx);
     }
@@ -338,12 +953,64 @@ public:
     int GetSegmentSize() const {
         return this->segmentSize;
     }
+
+    // Fraction of the allocated segment slots that hold elements.
+    double GetOccupancy() const {
+        int count = this->segments->GetLength();
+        return count == 0 ? 1.0 : static_cast<double>(totalSize) / (static_cast<double>(count) * segmentSize);
+    }
+
+    double GetLowWatermark() const {
+        return this->lowWatermark;
+    }
+
+    void SetLowWatermark(double watermark) {
+        if (watermark < 0.0 || watermark > 0.5) {
+            throw std::invalid_argument("Low watermark must be in [0, 0.5]");
+        }
+        this->lowWatermark = watermark;
+    }
+
+    double GetFillFactor() const {
+        return this->fillFactor;
+    }
+
+    void SetFillFactor(double factor) {
+        if (factor <= 0.0 || factor > 1.0) {
+            throw std::invalid_argument("Fill factor must be in (0, 1]");
+        }
+        this->fillFactor = factor;
+    }
+
+    // Repacks every element into segments of fillFactor * segmentSize, dropping empty ones.
+    void Compact() {
+        int target = std::max(1, static_cast<int>(segmentSize * fillFactor));
+        auto* packed = new ContainerSequence<SegmentSequence<T>*>();
+        SegmentSequence<T>* current = nullptr;
+        int count = this->segments->GetLength();
+        for (int i = 0; i < count; ++i) {
+            SegmentSequence<T>* segment = this->segments->GetUnchecked(i);
+            for (T& item : *segment) {
+                if (current == nullptr || current->GetLength() == target) {
+                    current = createSegment();
+                    packed->Append(current);
+                }
+                current->Append(std::move_if_noexcept(item));
+            }
+            delete segment;
+        }
+
+        delete this->segments;
+        this->segments = packed;
+        rebuildLengthIndex();
+    }
 };
 
 template <typename T, 
           template<typename> class SegmentSequence = MutableArraySequence,
           template<typename> class ContainerSequence = MutableArraySequence>
-class MutableSegmentedSequence : public SegmentedSequence<T, SegmentSequence, ContainerSequence> {
+class MutableSegmentedSequence final : public SegmentedSequence<T, SegmentSequence, ContainerSequence>,
+    public StaticSequence<MutableSegmentedSequence<T, SegmentSequence, ContainerSequence>, T> {
 public:
     using tag = MutableSequenceTag;
     explicit MutableSegmentedSequence(int segmentSize) : 
@@ -352,6 +1019,13 @@ public:
     MutableSegmentedSequence(const T* items, int count, int segmentSize) : 
         SegmentedSequence<T, SegmentSequence, ContainerSequence>(items, count, segmentSize) {}
 
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    MutableSegmentedSequence(InputIterator first, InputIterator last, int segmentSize) : 
+        SegmentedSequence<T, SegmentSequence, ContainerSequence>(first, last, segmentSize) {}
+
+    MutableSegmentedSequence(std::initializer_list<T> items, int segmentSize) : 
+        SegmentedSequence<T, SegmentSequence, ContainerSequence>(items, segmentSize) {}
+
     MutableSegmentedSequence(const Sequence<T>& other, int segmentSize) : 
         SegmentedSequence<T, SegmentSequence, ContainerSequence>(other, segmentSize) {}
 
@@ -365,9 +1039,30 @@ public:
         return this;
     }
 
+    MutableSegmentedSequence* ConcatMove(MutableSegmentedSequence& other) {
+        this->relinkSegments(other);
+        return this;
+    }
+
+    // Keeps [0, index) and returns the rest as a new sequence.
+    MutableSegmentedSequence* SplitAt(int index) {
+        auto* ret = new MutableSegmentedSequence(this->GetSegmentSize());
+        try {
+            this->splitSegmentsAt(index, *ret);
+        } catch (...) {
+            delete ret;
+            throw;
+        }
+        return ret;
+    }
+
     virtual Sequence<T>* CreateEmptySequence() const override {
         return new MutableSegmentedSequence<T, SegmentSequence, ContainerSequence>(this->GetSegmentSize());
     }
+
+    virtual Sequence<T>* CreateSequence(const T* items, int count) const override {
+        return new MutableSegmentedSequence<T, SegmentSequence, ContainerSequence>(items, count, this->GetSegmentSize());
+    }
     
     virtual SegmentedSequence<T, SegmentSequence, ContainerSequence>* CreateEmptySegSequence() const override {
         return new MutableSegmentedSequence<T, SegmentSequence, ContainerSequence>(this->GetSegmentSize());
@@ -375,41 +1070,43 @@ public:
 };
 
 
-template <typename T, 
-          template<typename> class SegmentSequence = MutableArraySequence,
-          template<typename> class ContainerSequence = MutableArraySequence>
-class ImmutableSegmentedSequence : public SegmentedSequence<T, SegmentSequence, ContainerSequence> {
+// Another name for the shared persistent vector (see PersistentSequence): it has no
+// segments, so it takes no segment size or segment container types.
+template <typename T>
+class ImmutableSegmentedSequence final : public PersistentSequence<T>, public StaticSequence<ImmutableSegmentedSequence<T>, T> {
 private:
-    SegmentedSequence<T, SegmentSequence, ContainerSequence>* Clone() const {
-        return new ImmutableSegmentedSequence<T, SegmentSequence, ContainerSequence>(*this);
+    PersistentSequence<T>* Clone() const {
+        Instrument::Clone();
+        return new ImmutableSegmentedSequence<T>(*this);
     }
 
 public:
     using tag = ImmutableSequenceTag;
-    explicit ImmutableSegmentedSequence(int segmentSize) : 
-        SegmentedSequence<T, SegmentSequence, ContainerSequence>(segmentSize) {}
-    
-    ImmutableSegmentedSequence(const T* items, int count, int segmentSize) : 
-        SegmentedSequence<T, SegmentSequence, ContainerSequence>(items, count, segmentSize) {}
-
-    ImmutableSegmentedSequence(const Sequence<T>& other, int segmentSize) : 
-        SegmentedSequence<T, SegmentSequence, ContainerSequence>(other, segmentSize) {}
 
-    ImmutableSegmentedSequence(ImmutableSegmentedSequence&& other) noexcept : 
-        SegmentedSequence<T, SegmentSequence, ContainerSequence>(std::move(other)) {}
+    ImmutableSegmentedSequence() : PersistentSequence<T>() {}
+    ImmutableSegmentedSequence(const T* items, int count) : PersistentSequence<T>(items, count) {}
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    ImmutableSegmentedSequence(InputIterator first, InputIterator last) : PersistentSequence<T>(first, last) {}
+    ImmutableSegmentedSequence(std::initializer_list<T> items) : PersistentSequence<T>(items) {}
+    ImmutableSegmentedSequence(const Sequence<T>& other) : PersistentSequence<T>(other) {}
+    ImmutableSegmentedSequence(const ImmutableSegmentedSequence<T>& other) : PersistentSequence<T>(other) {}
+    ImmutableSegmentedSequence(ImmutableSegmentedSequence<T>&& other) noexcept : PersistentSequence<T>(std::move(other)) {}
 
-    ImmutableSegmentedSequence(const ImmutableSegmentedSequence& other) : 
-        SegmentedSequence<T, SegmentSequence, ContainerSequence>(other) {}
-
-    virtual SegmentedSequence<T, SegmentSequence, ContainerSequence>* Instance() override {
+protected:
+    virtual PersistentSequence<T>* Instance() override {
         return Clone();
     }
 
+    virtual PersistentSequence<T>* CreateEmptyPersistentSequence() const override {
+        return new ImmutableSegmentedSequence<T>();
+    }
+
+public:
     virtual Sequence<T>* CreateEmptySequence() const override {
-        return new ImmutableSegmentedSequence<T, SegmentSequence, ContainerSequence>(this->GetSegmentSize());
+        return new ImmutableSegmentedSequence<T>();
     }
 
-    virtual SegmentedSequence<T, SegmentSequence, ContainerSequence>* CreateEmptySegSequence() const override {
-        return new ImmutableSegmentedSequence<T, SegmentSequence, ContainerSequence>(this->GetSegmentSize());
+    virtual Sequence<T>* CreateSequence(const T* items, int count) const override {
+        return new ImmutableSegmentedSequence<T>(items, count);
     }
 };
\ No newline at end of file
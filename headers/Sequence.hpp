@@ -2,18 +2,37 @@
 #include <stdexcept>
 #include <memory>
 #include <functional>
+#include <iterator>
+#include <type_traits>
+#include <initializer_list>
 #include "DynamicArray.hpp"
 #include "LinkedList.hpp"
+#include "PersistentVector.hpp"
+#include "Parallel.hpp"
+#include "StaticSequence.hpp"
 
 
+template <typename T> class MutableArraySequence;
+template <typename T> class ImmutableArraySequence;
+template <typename T> class PersistentSequence;
+template <typename T> class SequenceView;
+
 template <typename T>
 class Sequence {
 public:
+    using value_type = T;
+
     virtual Sequence<T>* CreateEmptySequence() const = 0;
     virtual Sequence<T>* AppendInternal(const T& item) = 0;
     virtual Sequence<T>* PrependInternal(const T& item) = 0;
     virtual Sequence<T>* InsertAtInternal(const T& item, int index) = 0;
+    virtual Sequence<T>* AppendInternal(T&& item) = 0;
+    virtual Sequence<T>* PrependInternal(T&& item) = 0;
+    virtual Sequence<T>* InsertAtInternal(T&& item, int index) = 0;
     virtual Sequence<T>* ConcatInternal(const Sequence<T>* other) = 0;
+    virtual Sequence<T>* RemoveAtInternal(int index) = 0;
+    virtual Sequence<T>* RemoveRangeInternal(int startIndex, int endIndex) = 0;
+    virtual Sequence<T>* RemoveIfInternal(const std::function<bool(const T&)>& predicate) = 0;
 
     virtual ~Sequence() = default;
 
@@ -25,61 +44,294 @@ public:
     virtual T& GetLast() = 0;
     virtual T& Get(int index) = 0;
 
+    // Get without the bounds check: index must be in [0, GetLength()). Meant for loops
+    // whose range is already validated; Get and operator[] remain the checked entry points.
+    virtual const T& GetUnchecked(int index) const = 0;
+    virtual T& GetUnchecked(int index) = 0;
+
     virtual int GetLength() const = 0;
 
     virtual Sequence<T>* Append(const T& item) = 0;
     virtual Sequence<T>* Prepend(const T& item) = 0;
     virtual Sequence<T>* InsertAt(const T& item, int index) = 0;
+    virtual Sequence<T>* Append(T&& item) = 0;
+    virtual Sequence<T>* Prepend(T&& item) = 0;
+    virtual Sequence<T>* InsertAt(T&& item, int index) = 0;
     virtual Sequence<T>* Concat(const Sequence<T>* other) = 0;
 
+    // Like the insertions, removals change a mutable sequence in place and return it, and
+    // return a new version of an immutable one. RemoveRange drops [startIndex, endIndex],
+    // whichever order the ends are given in.
+    virtual Sequence<T>* RemoveAt(int index) = 0;
+    virtual Sequence<T>* RemoveRange(int startIndex, int endIndex) = 0;
+    virtual Sequence<T>* RemoveIf(const std::function<bool(const T&)>& predicate) = 0;
+
+    Sequence<T>* PopFront() {
+        if (this->GetLength() == 0) {
+            throw std::out_of_range("Sequence is empty");
+        }
+        return this->RemoveAt(0);
+    }
+
+    Sequence<T>* PopBack() {
+        if (this->GetLength() == 0) {
+            throw std::out_of_range("Sequence is empty");
+        }
+        return this->RemoveAt(this->GetLength() - 1);
+    }
+
+    // The element is built here and handed to the rvalue overload, which moves it into place.
+    template <typename... Args>
+    Sequence<T>* EmplaceBack(Args&&... args) {
+        return this->Append(T(std::forward<Args>(args)...));
+    }
+
+    template <typename... Args>
+    Sequence<T>* EmplaceFront(Args&&... args) {
+        return this->Prepend(T(std::forward<Args>(args)...));
+    }
+
+    template <typename... Args>
+    Sequence<T>* EmplaceAt(int index, Args&&... args) {
+        return this->InsertAt(T(std::forward<Args>(args)...), index);
+    }
+
     virtual T& operator[] (int index) = 0;
 
     virtual Sequence<T>* GetSubsequence(int startIndex, int endIndex) const = 0;
 
-    Sequence<T>* Map(std::function<T(T)> mapper) const {
-        Sequence<T>* result = this->CreateEmptySequence();
-        for (int i = 0; i < this->GetLength(); ++i) {
-            result = result->Append(mapper(this->Get(i)));
+    // Hands the elements over in order as runs of contiguous storage; array-backed
+    // sequences produce one run per buffer, node-based ones one run per element.
+    // The walk stops, and false is returned, as soon as the visitor returns false.
+    virtual bool ForEachChunk(const std::function<bool(const T*, int)>& visitor) const = 0;
+    virtual Sequence<T>* CreateSequence(const T* items, int count) const = 0;
+
+    // Like CreateSequence, but may take over the buffer instead of copying it; by default
+    // the items are copied.
+    virtual Sequence<T>* CreateSequenceFrom(DynamicArray<T>&& buffer) const {
+        return this->CreateSequence(buffer.begin(), buffer.GetSize());
+    }
+
+    void ForEach(const std::function<void(const T&)>& visitor) const {
+        this->ForEachChunk([&visitor](const T* items, int count) {
+            for (int i = 0; i < count; ++i) {
+                visitor(items[i]);
+            }
+            return true;
+        });
+    }
+
+    // Result keeps the kind of this sequence when the element type is unchanged; otherwise
+    // it is an array sequence with the same mutability.
+    template <typename F, typename U = std::decay_t<std::invoke_result_t<F&, const T&>>>
+    Sequence<U>* Map(F mapper) const {
+        DynamicArray<U> buffer;
+        buffer.Reserve(this->GetLength());
+        this->ForEachChunk([&mapper, &buffer](const T* items, int count) {
+            for (int i = 0; i < count; ++i) {
+                buffer.EmplaceBack(mapper(items[i]));
+            }
+            return true;
+        });
+
+        return this->CreateMapped(std::move(buffer));
+    }
+
+    template <typename F, typename = std::enable_if_t<std::is_invocable_r_v<bool, F&, const T&>>>
+    Sequence<T>* Where(F wherer) const {
+        DynamicArray<T> buffer;
+        this->ForEachChunk([&wherer, &buffer](const T* items, int count) {
+            for (int i = 0; i < count; ++i) {
+                if (wherer(items[i])) {
+                    buffer.EmplaceBack(items[i]);
+                }
+            }
+            return true;
+        });
+        return this->CreateSequenceFrom(std::move(buffer));
+    }
+
+    template <typename F, typename = std::enable_if_t<std::is_invocable_r_v<T, F&, const T&, const T&>>>
+    T Reduce(F reducer, const T& startVal) const {
+        T accumulator = startVal;
+        this->ForEachChunk([&reducer, &accumulator](const T* items, int count) {
+            for (int i = 0; i < count; ++i) {
+                accumulator = reducer(accumulator, items[i]);
+            }
+            return true;
+        });
+        return accumulator;
+    }
+
+    template <typename F, typename U = std::decay_t<std::invoke_result_t<F&, const T&>>>
+    Sequence<U>* Map(const ParallelPolicy& policy, F mapper) const {
+        DynamicArray<ParallelChunk> chunks;
+        DynamicArray<int> bounds;
+        if (!this->SplitForParallel(policy, chunks, bounds)) {
+            return this->Map(mapper);
         }
-        return result;
+
+        DynamicArray<int> offsets(bounds.GetSize());
+        for (int p = 0; p + 1 < bounds.GetSize(); ++p) {
+            offsets[p] = chunks[bounds[p]].offset;
+        }
+        offsets[bounds.GetSize() - 1] = this->GetLength();
+
+        const ParallelChunk* chunk = chunks.begin();
+        const int* bound = bounds.begin();
+        DynamicArray<U> buffer = constructPieces<U>(policy, offsets, [&mapper, chunk, bound](int p, auto& emit) {
+            for (int c = bound[p]; c < bound[p + 1]; ++c) {
+                for (int i = 0; i < chunk[c].count; ++i) {
+                    emit(mapper(chunk[c].items[i]));
+                }
+            }
+        });
+        return this->CreateMapped(std::move(buffer));
+    }
+
+    // The predicate runs once per item: the first pass records its answers and counts the
+    // survivors of every piece, the second copies them to their final places.
+    template <typename F, typename = std::enable_if_t<std::is_invocable_r_v<bool, F&, const T&>>>
+    Sequence<T>* Where(const ParallelPolicy& policy, F wherer) const {
+        DynamicArray<ParallelChunk> chunks;
+        DynamicArray<int> bounds;
+        if (!this->SplitForParallel(policy, chunks, bounds)) {
+            return this->Where(wherer);
+        }
+
+        DynamicArray<char> flags;
+        flags.Reserve(this->GetLength());
+        DynamicArray<int> offsets(bounds.GetSize());
+        char* keep = flags.end();
+        int* kept = offsets.begin() + 1;
+        const ParallelChunk* chunk = chunks.begin();
+        const int* bound = bounds.begin();
+        policy.GetPool().Run(bounds.GetSize() - 1, [&wherer, keep, kept, chunk, bound](int p) {
+            int survivors = 0;
+            for (int c = bound[p]; c < bound[p + 1]; ++c) {
+                for (int i = 0; i < chunk[c].count; ++i) {
+                    keep[chunk[c].offset + i] = wherer(chunk[c].items[i]) ? 1 : 0;
+                    survivors += keep[chunk[c].offset + i];
+                }
+            }
+            kept[p] = survivors;
+        });
+        flags.Adopt(this->GetLength());
+        for (int p = 1; p < offsets.GetSize(); ++p) {
+            offsets[p] += offsets[p - 1];
+        }
+
+        DynamicArray<T> buffer = constructPieces<T>(policy, offsets, [keep, chunk, bound](int p, auto& emit) {
+            for (int c = bound[p]; c < bound[p + 1]; ++c) {
+                for (int i = 0; i < chunk[c].count; ++i) {
+                    if (keep[chunk[c].offset + i]) {
+                        emit(chunk[c].items[i]);
+                    }
+                }
+            }
+        });
+        return this->CreateSequenceFrom(std::move(buffer));
+    }
+
+    // The reducer must be associative: pieces are folded independently and their
+    // partial results are then combined pairwise, level by level, keeping their order.
+    template <typename F, typename = std::enable_if_t<std::is_invocable_r_v<T, F&, const T&, const T&>>>
+    T Reduce(const ParallelPolicy& policy, F reducer, const T& startVal) const {
+        DynamicArray<ParallelChunk> chunks;
+        DynamicArray<int> bounds;
+        if (!this->SplitForParallel(policy, chunks, bounds)) {
+            return this->Reduce(reducer, startVal);
+        }
+
+        DynamicArray<int> offsets(bounds.GetSize());
+        for (int p = 0; p < offsets.GetSize(); ++p) {
+            offsets[p] = p;
+        }
+
+        const ParallelChunk* chunk = chunks.begin();
+        const int* bound = bounds.begin();
+        DynamicArray<T> partials = constructPieces<T>(policy, offsets, [&reducer, chunk, bound](int p, auto& emit) {
+            T accumulator = chunk[bound[p]].items[0];
+            for (int c = bound[p]; c < bound[p + 1]; ++c) {
+                for (int i = c == bound[p] ? 1 : 0; i < chunk[c].count; ++i) {
+                    accumulator = reducer(accumulator, chunk[c].items[i]);
+                }
+            }
+            emit(std::move(accumulator));
+        });
+
+        T* partial = partials.begin();
+        int count = partials.GetSize();
+        for (int width = 1; width < count; width *= 2) {
+            policy.GetPool().Run((count + 2 * width - 1) / (2 * width), [&reducer, partial, count, width](int pair) {
+                int left = pair * 2 * width;
+                if (left + width < count) {
+                    partial[left] = reducer(partial[left], partial[left + width]);
+                }
+            });
+        }
+        return reducer(startVal, partial[0]);
+    }
+
+    Sequence<T>* Map(std::function<T(T)> mapper) const {
+        DynamicArray<T> buffer;
+        buffer.Reserve(this->GetLength());
+        this->ForEach([&](const T& item) {
+            buffer.EmplaceBack(mapper(item));
+        });
+        return this->CreateSequenceFrom(std::move(buffer));
     }
 
     Sequence<T>* Map(std::function<T(T, int)> mapper) const {
-        Sequence<T>* result = this->CreateEmptySequence();
-        for (int i = 0; i < this->GetLength(); ++i) {
-            result->Append(mapper(this->Get(i), i));
-        }
-        return result;
+        DynamicArray<T> buffer;
+        buffer.Reserve(this->GetLength());
+        this->ForEach([&](const T& item) {
+            buffer.EmplaceBack(mapper(item, buffer.GetSize()));
+        });
+        return this->CreateSequenceFrom(std::move(buffer));
     }
 
     Sequence<T>* Where(std::function<bool(T)> wherer) const {
-        Sequence<T>* result = this->CreateEmptySequence();
-        for (int i = 0; i < this->GetLength(); ++i) {
-            if (wherer(this->Get(i))) {
-                result = result->Append(this->Get(i));
+        DynamicArray<T> buffer;
+        this->ForEach([&](const T& item) {
+            if (wherer(item)) {
+                buffer.EmplaceBack(item);
             }
-        }
-        return result;
+        });
+        return this->CreateSequenceFrom(std::move(buffer));
     }
 
-    T& Reduce(std::function<T(T, T)> reducer, const T& startVal) const {
+    T Reduce(std::function<T(T, T)> reducer, const T& startVal) const {
         T accumulator = startVal;
-        for (int i = 0; i < this->GetLength(); ++i) {
-            accumulator = reducer(accumulator, this->Get(i));
-        }
+        this->ForEach([&](const T& item) {
+            accumulator = reducer(accumulator, item);
+        });
         return accumulator;
     }
 
+    // Index-based iteration through the virtual interface; concrete sequences hide these
+    // with iterators over their own storage.
     class Iterator {
     private:
         Sequence<T>* sequence;
         int index;
     
     public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        Iterator() : sequence(nullptr), index(0) {}
         Iterator(Sequence<T>* seq, int ind) : sequence(seq), index(ind) {}
 
-        T& operator*() {
-            return sequence->Get(index);
+        T& operator*() const {
+            return sequence->GetUnchecked(index);
+        }
+
+        T* operator->() const {
+            return &sequence->GetUnchecked(index);
         }
 
         Iterator& operator++() {
@@ -87,11 +339,64 @@ public:
             return *this;
         }
 
+        Iterator operator++(int) {
+            Iterator ret = *this;
+            ++index;
+            return ret;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return index == other.index;
+        }
+
         bool operator!=(const Iterator& other) const {
             return index != other.index;
         }
     };
 
+    class ConstIterator {
+    private:
+        const Sequence<T>* sequence;
+        int index;
+    
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        ConstIterator() : sequence(nullptr), index(0) {}
+        ConstIterator(const Sequence<T>* seq, int ind) : sequence(seq), index(ind) {}
+
+        const T& operator*() const {
+            return sequence->GetUnchecked(index);
+        }
+
+        const T* operator->() const {
+            return &sequence->GetUnchecked(index);
+        }
+
+        ConstIterator& operator++() {
+            ++index;
+            return *this;
+        }
+
+        ConstIterator operator++(int) {
+            ConstIterator ret = *this;
+            ++index;
+            return ret;
+        }
+
+        bool operator==(const ConstIterator& other) const {
+            return index == other.index;
+        }
+
+        bool operator!=(const ConstIterator& other) const {
+            return index != other.index;
+        }
+    };
+
     Iterator begin() {
         return Iterator(this, 0);
     }
@@ -99,51 +404,186 @@ public:
     Iterator end() {
         return Iterator(this, this->GetLength());
     }
-};
 
+    ConstIterator begin() const {
+        return ConstIterator(this, 0);
+    }
+
+    ConstIterator end() const {
+        return ConstIterator(this, this->GetLength());
+    }
+
+private:
+    template <typename> friend class SequenceView;
+
+    struct ParallelChunk {
+        const T* items = nullptr;
+        int count = 0;
+        int offset = 0;
+    };
+
+    // Cuts the storage runs into chunks of at most one grain and groups consecutive
+    // chunks into pieces of about a grain each; piece p covers chunks [bounds[p], bounds[p + 1]).
+    // Fails when there is too little data or the runs are too short to be worth it.
+    bool SplitForParallel(const ParallelPolicy& policy, DynamicArray<ParallelChunk>& chunks, DynamicArray<int>& bounds) const {
+        int length = this->GetLength();
+        int concurrency = policy.GetPool().GetConcurrency();
+        if (length < policy.minLength || concurrency <= 1) {
+            return false;
+        }
+
+        int grain = std::max(policy.minGrain, length / (concurrency * 4));
+        int offset = 0;
+        int pieceSize = 0;
+        bounds.Resize(1);
+        bounds[0] = 0;
+        bool complete = this->ForEachChunk([&](const T* items, int count) {
+            if (chunks.GetSize() >= 64 && offset < chunks.GetSize() * 4) {
+                return false;
+            }
+            for (int start = 0; start < count; start += grain) {
+                int part = std::min(grain, count - start);
+                chunks.Resize(chunks.GetSize() + 1);
+                chunks[chunks.GetSize() - 1] = ParallelChunk{items + start, part, offset + start};
+                pieceSize += part;
+                if (pieceSize >= grain) {
+                    bounds.Resize(bounds.GetSize() + 1);
+                    bounds[bounds.GetSize() - 1] = chunks.GetSize();
+                    pieceSize = 0;
+                }
+            }
+            offset += count;
+            return true;
+        });
+
+        if (!complete) {
+            return false;
+        }
+        if (pieceSize > 0) {
+            bounds.Resize(bounds.GetSize() + 1);
+            bounds[bounds.GetSize() - 1] = chunks.GetSize();
+        }
+        return bounds.GetSize() > 2;
+    }
+
+    // Piece p constructs its items in place, through emit, from slot offsets[p] of one
+    // block reserved for all of them; the finished block becomes the result as it is. When
+    // a piece throws, whatever the pieces built is destroyed before the exception goes on.
+    template <typename U, typename Fill>
+    static DynamicArray<U> constructPieces(const ParallelPolicy& policy, const DynamicArray<int>& offsets, Fill fill) {
+        int pieces = offsets.GetSize() - 1;
+        DynamicArray<U> result;
+        result.Reserve(offsets.Get(pieces));
+        DynamicArray<int> built(pieces);
+        U* out = result.end();
+        int* done = built.begin();
+        const int* offset = offsets.begin();
+        try {
+            policy.GetPool().Run(pieces, [&fill, out, done, offset](int p) {
+                U* target = out + offset[p];
+                int& count = done[p];
+                auto emit = [target, &count](auto&&... args) {
+                    Instrument::Construction<U, decltype(args)...>();
+                    ::new (static_cast<void*>(target + count)) U(std::forward<decltype(args)>(args)...);
+                    ++count;
+                };
+                fill(p, emit);
+            });
+        } catch (...) {
+            for (int p = 0; p < pieces; ++p) {
+                std::destroy(out + offset[p], out + offset[p] + done[p]);
+            }
+            throw;
+        }
+        result.Adopt(offsets.Get(pieces));
+        return result;
+    }
+
+    template <typename U>
+    Sequence<U>* CreateMapped(DynamicArray<U>&& buffer) const {
+        if constexpr (std::is_same_v<U, T>) {
+            return this->CreateSequenceFrom(std::move(buffer));
+        } else if (dynamic_cast<const PersistentSequence<T>*>(this) != nullptr) {
+            return new ImmutableArraySequence<U>(std::move(buffer));
+        } else {
+            return new MutableArraySequence<U>(std::move(buffer));
+        }
+    }
+};
 
-template <typename T> class MutableArraySequence;
-template <typename T> class ImmutableArraySequence;
 
 template <typename T>
 class ArraySequence : public Sequence<T> {
 private:
     DynamicArray<T>* data;
 
-    virtual Sequence<T>* AppendInternal(const T& item) override {
-        this->data->Resize(data->GetSize() + 1);
-        this->data->Set(item, this->data->GetSize() - 1);
+    template <typename U>
+    Sequence<T>* appendItem(U&& item) {
+        this->data->EmplaceBack(std::forward<U>(item));
         return this;
     }
 
-    virtual Sequence<T>* PrependInternal(const T& item) override {
-        this->data->Resize(data->GetSize() + 1);
-
-        for (int i = this->data->GetSize() - 1; i > 0; --i) {
-            this->data->Set(this->data->Get(i - 1), i);
-        }
+    template <typename U>
+    Sequence<T>* prependItem(U&& item) {
+        this->data->EmplaceFront(std::forward<U>(item));
+        return this;
+    }
 
-        this->data->Set(item, 0);
+    template <typename U>
+    Sequence<T>* insertItem(U&& item, int index) {
+        this->data->EmplaceAt(index, std::forward<U>(item));
         return this;
     }
 
+    virtual Sequence<T>* AppendInternal(const T& item) override {
+        return appendItem(item);
+    }
+
+    virtual Sequence<T>* AppendInternal(T&& item) override {
+        return appendItem(std::move(item));
+    }
+
+    virtual Sequence<T>* PrependInternal(const T& item) override {
+        return prependItem(item);
+    }
+
+    virtual Sequence<T>* PrependInternal(T&& item) override {
+        return prependItem(std::move(item));
+    }
+
     virtual Sequence<T>* InsertAtInternal(const T& item, int index) override {
-        this->data->Resize(data->GetSize() + 1);
-        if (index == 0)
-            return AppendInternal(item);
+        return insertItem(item, index);
+    }
 
-        for (int i = this->data->GetSize() - 1; i >= index; --i) {
-            this->data->Set(this->data->Get(i - 1), i);
-        }
+    virtual Sequence<T>* InsertAtInternal(T&& item, int index) override {
+        return insertItem(std::move(item), index);
+    }
 
-        this->data->Set(item, index);
+    virtual Sequence<T>* ConcatInternal(const Sequence<T>* other) override {
+        // Copies only the items present on entry and reserves up front, so other may be this.
+        int remaining = other->GetLength();
+        this->data->Reserve(this->data->GetSize() + remaining);
+        other->ForEachChunk([this, &remaining](const T* items, int count) {
+            for (int i = 0; i < count && remaining > 0; ++i, --remaining) {
+                this->data->EmplaceBack(items[i]);
+            }
+            return remaining > 0;
+        });
         return this;
     }
 
-    virtual Sequence<T>* ConcatInternal(const Sequence<T>* other) override {
-        for (int i = 0; i < other->GetLength(); ++i) {
-            this->Append(other->Get(i));
-        }
+    virtual Sequence<T>* RemoveAtInternal(int index) override {
+        this->data->RemoveAt(index);
+        return this;
+    }
+
+    virtual Sequence<T>* RemoveRangeInternal(int startIndex, int endIndex) override {
+        this->data->RemoveRange(startIndex, endIndex);
+        return this;
+    }
+
+    virtual Sequence<T>* RemoveIfInternal(const std::function<bool(const T&)>& predicate) override {
+        this->data->RemoveIf(predicate);
         return this;
     }
 
@@ -154,10 +594,18 @@ protected:
 public:
     ArraySequence() : data(new DynamicArray<T>()) {}
     ArraySequence(const T* items, int count) : data(new DynamicArray<T>(items, count)) {}
-    ArraySequence(const Sequence<T>& other) : data(new DynamicArray<T>(other.GetSize())) {
-        for (int i = 0; i < other.GetSize(); ++i) {
-            data->Append(other.Get(i));
-        }
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    ArraySequence(InputIterator first, InputIterator last) : data(new DynamicArray<T>(first, last)) {}
+    ArraySequence(std::initializer_list<T> items) : ArraySequence(items.begin(), static_cast<int>(items.size())) {}
+    explicit ArraySequence(DynamicArray<T>&& buffer) : data(new DynamicArray<T>(std::move(buffer))) {}
+    ArraySequence(const Sequence<T>& other) : ArraySequence() {
+        data->Reserve(other.GetLength());
+        other.ForEachChunk([this](const T* items, int count) {
+            for (int i = 0; i < count; ++i) {
+                data->EmplaceBack(items[i]);
+            }
+            return true;
+        });
     }
     ArraySequence(ArraySequence<T>&& other) noexcept : data(other.data) {
         other.data = nullptr;
@@ -168,6 +616,36 @@ public:
         delete data;
     }
 
+    using Iterator = typename DynamicArray<T>::Iterator;
+    using ConstIterator = typename DynamicArray<T>::ConstIterator;
+
+    Iterator begin() {
+        return this->data->begin();
+    }
+
+    Iterator end() {
+        return this->data->end();
+    }
+
+    ConstIterator begin() const {
+        return static_cast<const DynamicArray<T>*>(this->data)->begin();
+    }
+
+    ConstIterator end() const {
+        return static_cast<const DynamicArray<T>*>(this->data)->end();
+    }
+
+    // Non-virtual ForEachChunk, for StaticSequence and other callers that know the type.
+    template <typename Visitor>
+    bool VisitChunks(Visitor&& visitor) const {
+        int length = this->data->GetSize();
+        return length == 0 || visitor(static_cast<const T*>(this->data->begin()), length);
+    }
+
+    bool ForEachChunk(const std::function<bool(const T*, int)>& visitor) const override {
+        return this->VisitChunks(visitor);
+    }
+
     int GetLength() const override {
         return this->data->GetSize();
     }
@@ -177,7 +655,7 @@ public:
             throw std::out_of_range("Sequence is empty - cannot get first element");
         }
 
-        return this->data->Get(0);
+        return this->data->GetUnchecked(0);
     }
 
     const T& GetLast() const override {
@@ -185,7 +663,7 @@ public:
             throw std::out_of_range("Sequence is empty - cannot get last element");
         }
 
-        return data->Get(data->GetSize() - 1);
+        return data->GetUnchecked(data->GetSize() - 1);
     }
 
     const T& Get(int index) const override {
@@ -193,7 +671,11 @@ public:
             throw std::out_of_range("Sequence index out of range");
         }
 
-        return data->Get(index);
+        return data->GetUnchecked(index);
+    }
+
+    const T& GetUnchecked(int index) const override {
+        return data->GetUnchecked(index);
     }
 
     T& GetFirst() override {
@@ -201,7 +683,7 @@ public:
             throw std::out_of_range("Sequence is empty - cannot get first element");
         }
 
-        return this->data->Get(0);
+        return this->data->GetUnchecked(0);
     }
 
     T& GetLast() override {
@@ -209,7 +691,7 @@ public:
             throw std::out_of_range("Sequence is empty - cannot get last element");
         }
 
-        return data->Get(data->GetSize() - 1);
+        return data->GetUnchecked(data->GetSize() - 1);
     }
 
     T& Get(int index) override {
@@ -217,7 +699,11 @@ public:
             throw std::out_of_range("Sequence index out of range");
         }
 
-        return data->Get(index);
+        return data->GetUnchecked(index);
+    }
+
+    T& GetUnchecked(int index) override {
+        return data->GetUnchecked(index);
     }
 
     T& operator[] (int index) override {
@@ -250,11 +736,11 @@ public:
 
         if (startIndex <= endIndex) {
             for (int i = startIndex; i <= endIndex; ++i) {
-                ret->Append(data->Get(i));
+                ret->Append(data->GetUnchecked(i));
             }
         } else {
             for (int i = startIndex; i >= endIndex; --i) {
-                ret->Append(data->Get(i));
+                ret->Append(data->GetUnchecked(i));
             }
         }
 
@@ -265,10 +751,18 @@ public:
         return Instance()->AppendInternal(item);
     }
 
+    virtual Sequence<T>* Append(T&& item) override {
+        return Instance()->AppendInternal(std::move(item));
+    }
+
     virtual Sequence<T>* Prepend(const T& item) override {
         return Instance()->PrependInternal(item);
     }
 
+    virtual Sequence<T>* Prepend(T&& item) override {
+        return Instance()->PrependInternal(std::move(item));
+    }
+
     virtual Sequence<T>* InsertAt(const T& item, int index) override {
         if (index < 0 || index >= data->GetSize()) {
             throw std::out_of_range("ArraySequence index out of range");
@@ -277,9 +771,35 @@ public:
         return Instance()->InsertAtInternal(item, index);
     }
 
+    virtual Sequence<T>* InsertAt(T&& item, int index) override {
+        if (index < 0 || index >= data->GetSize()) {
+            throw std::out_of_range("ArraySequence index out of range");
+        }
+
+        return Instance()->InsertAtInternal(std::move(item), index);
+    }
+
     virtual Sequence<T>* Concat(const Sequence<T>* other) override {
         return this->Instance()->ConcatInternal(other);
     }
+
+    virtual Sequence<T>* RemoveAt(int index) override {
+        if (index < 0 || index >= data->GetSize()) {
+            throw std::out_of_range("ArraySequence index out of range");
+        }
+        return this->Instance()->RemoveAtInternal(index);
+    }
+
+    virtual Sequence<T>* RemoveRange(int startIndex, int endIndex) override {
+        if (std::min(startIndex, endIndex) < 0 || std::max(startIndex, endIndex) >= data->GetSize()) {
+            throw std::out_of_range("ArraySequence index out of range");
+        }
+        return this->Instance()->RemoveRangeInternal(std::min(startIndex, endIndex), std::max(startIndex, endIndex));
+    }
+
+    virtual Sequence<T>* RemoveIf(const std::function<bool(const T&)>& predicate) override {
+        return this->Instance()->RemoveIfInternal(predicate);
+    }
 };
 
 template <typename T> class MutableListSequence;
@@ -288,6 +808,8 @@ template <typename T> class ImmutableListSequence;
 template <typename T>
 class ListSequence : public Sequence<T> {
 private:
+    friend class MutableListSequence<T>;
+
     LinkedList<T>* data;
 
     virtual Sequence<T>* AppendInternal(const T& item) override {
@@ -295,20 +817,55 @@ private:
         return this;
     }
 
+    virtual Sequence<T>* AppendInternal(T&& item) override {
+        this->data->Append(std::move(item));
+        return this;
+    }
+
     virtual Sequence<T>* PrependInternal(const T& item) override {
         this->data->Prepend(item);
         return this;
     }
 
+    virtual Sequence<T>* PrependInternal(T&& item) override {
+        this->data->Prepend(std::move(item));
+        return this;
+    }
+
     virtual Sequence<T>* InsertAtInternal(const T& item, int index) override {
         this->data->InsertAt(item, index);
         return this;
     }
 
+    virtual Sequence<T>* InsertAtInternal(T&& item, int index) override {
+        this->data->InsertAt(std::move(item), index);
+        return this;
+    }
+
     virtual Sequence<T>* ConcatInternal(const Sequence<T>* other) override {
-        for (int i = 0; i < other->GetLength(); ++i) {
-            this->Append(other->Get(i));
-        }
+        // Appends never move existing items, so stopping at the entry length lets other be this.
+        int remaining = other->GetLength();
+        other->ForEachChunk([this, &remaining](const T* items, int count) {
+            for (int i = 0; i < count && remaining > 0; ++i, --remaining) {
+                this->data->Append(items[i]);
+            }
+            return remaining > 0;
+        });
+        return this;
+    }
+
+    virtual Sequence<T>* RemoveAtInternal(int index) override {
+        this->data->RemoveAt(index);
+        return this;
+    }
+
+    virtual Sequence<T>* RemoveRangeInternal(int startIndex, int endIndex) override {
+        this->data->RemoveRange(startIndex, endIndex);
+        return this;
+    }
+
+    virtual Sequence<T>* RemoveIfInternal(const std::function<bool(const T&)>& predicate) override {
+        this->data->RemoveIf(predicate);
         return this;
     }
 
@@ -319,10 +876,16 @@ protected:
 public:
     ListSequence() : data(new LinkedList<T>()) {}
     ListSequence(const T* items, int count) : data(new LinkedList<T>(items, count)) {}
-    ListSequence(const Sequence<T>& other) : data(new LinkedList<T>()) {
-        for (int i = 0; i < other.GetSize(); ++i) {
-            data->Set(i, other.Get(i));
-        }
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    ListSequence(InputIterator first, InputIterator last) : data(new LinkedList<T>(first, last)) {}
+    ListSequence(std::initializer_list<T> items) : ListSequence(items.begin(), static_cast<int>(items.size())) {}
+    ListSequence(const Sequence<T>& other) : ListSequence() {
+        other.ForEachChunk([this](const T* items, int count) {
+            for (int i = 0; i < count; ++i) {
+                data->EmplaceBack(items[i]);
+            }
+            return true;
+        });
     }
     ListSequence(ListSequence<T>&& other) noexcept : data(other.data) {
         other.data = nullptr;
@@ -333,6 +896,39 @@ public:
         delete this->data;
     }
 
+    using Iterator = typename LinkedList<T>::Iterator;
+    using ConstIterator = typename LinkedList<T>::ConstIterator;
+
+    Iterator begin() {
+        return this->data->begin();
+    }
+
+    Iterator end() {
+        return this->data->end();
+    }
+
+    ConstIterator begin() const {
+        return static_cast<const LinkedList<T>*>(this->data)->begin();
+    }
+
+    ConstIterator end() const {
+        return static_cast<const LinkedList<T>*>(this->data)->end();
+    }
+
+    template <typename Visitor>
+    bool VisitChunks(Visitor&& visitor) const {
+        for (const T& item : *static_cast<const LinkedList<T>*>(this->data)) {
+            if (!visitor(&item, 1)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool ForEachChunk(const std::function<bool(const T*, int)>& visitor) const override {
+        return this->VisitChunks(visitor);
+    }
+
     int GetLength() const override {
         return this->data->GetSize();
     }
@@ -358,7 +954,11 @@ public:
             throw std::out_of_range("Sequence index out of range");
         }
 
-        return this->data->Get(index);
+        return static_cast<const LinkedList<T>*>(this->data)->GetUnchecked(index);
+    }
+
+    const T& GetUnchecked(int index) const override {
+        return static_cast<const LinkedList<T>*>(this->data)->GetUnchecked(index);
     }
 
     T& GetFirst() override {
@@ -382,7 +982,11 @@ public:
             throw std::out_of_range("Sequence index out of range");
         }
 
-        return this->data->Get(index);
+        return this->data->GetUnchecked(index);
+    }
+
+    T& GetUnchecked(int index) override {
+        return this->data->GetUnchecked(index);
     }
 
     T& operator[] (int index) override {
@@ -412,6 +1016,7 @@ public:
         }
 
         ListSequence<T>* ret = this->CreateEmptyListSequence();
+        delete ret->data;
         ret->data = this->data->GetSubList(startIndex, endIndex);
 
         return ret;
@@ -421,10 +1026,18 @@ public:
         return this->Instance()->AppendInternal(item);
     }
 
+    virtual Sequence<T>* Append(T&& item) override {
+        return this->Instance()->AppendInternal(std::move(item));
+    }
+
     virtual Sequence<T>* Prepend(const T& item) override {
         return this->Instance()->PrependInternal(item);
     }
 
+    virtual Sequence<T>* Prepend(T&& item) override {
+        return this->Instance()->PrependInternal(std::move(item));
+    }
+
     virtual Sequence<T>* InsertAt(const T& item, int index) override {
         if (index < 0 || index >= this->data->GetSize()) {
             throw std::out_of_range("Sequence index out of range");
@@ -432,9 +1045,286 @@ public:
         return this->Instance()->InsertAtInternal(item, index);
     }
 
+    virtual Sequence<T>* InsertAt(T&& item, int index) override {
+        if (index < 0 || index >= this->data->GetSize()) {
+            throw std::out_of_range("Sequence index out of range");
+        }
+        return this->Instance()->InsertAtInternal(std::move(item), index);
+    }
+
+    virtual Sequence<T>* Concat(const Sequence<T>* other) override {
+        return this->Instance()->ConcatInternal(other);
+    }
+
+    virtual Sequence<T>* RemoveAt(int index) override {
+        if (index < 0 || index >= this->data->GetSize()) {
+            throw std::out_of_range("Sequence index out of range");
+        }
+        return this->Instance()->RemoveAtInternal(index);
+    }
+
+    virtual Sequence<T>* RemoveRange(int startIndex, int endIndex) override {
+        if (std::min(startIndex, endIndex) < 0 || std::max(startIndex, endIndex) >= this->data->GetSize()) {
+            throw std::out_of_range("Sequence index out of range");
+        }
+        return this->Instance()->RemoveRangeInternal(std::min(startIndex, endIndex), std::max(startIndex, endIndex));
+    }
+
+    virtual Sequence<T>* RemoveIf(const std::function<bool(const T&)>& predicate) override {
+        return this->Instance()->RemoveIfInternal(predicate);
+    }
+};
+
+
+// Common base of every Immutable* sequence. They all store a PersistentVector, so the
+// immutable array, list, unrolled list, adaptive and segmented sequences are aliases of
+// one persistent vector: they differ only in type and in the factories they return, not
+// in layout, complexity or API.
+template <typename T>
+class PersistentSequence : public Sequence<T> {
+private:
+    PersistentVector<T> data;
+
+    virtual Sequence<T>* AppendInternal(const T& item) override {
+        this->data = this->data.Append(item);
+        return this;
+    }
+
+    virtual Sequence<T>* AppendInternal(T&& item) override {
+        this->data = this->data.Append(std::move(item));
+        return this;
+    }
+
+    virtual Sequence<T>* PrependInternal(const T& item) override {
+        this->data = this->data.Prepend(item);
+        return this;
+    }
+
+    virtual Sequence<T>* PrependInternal(T&& item) override {
+        this->data = this->data.Prepend(std::move(item));
+        return this;
+    }
+
+    virtual Sequence<T>* InsertAtInternal(const T& item, int index) override {
+        this->data = this->data.InsertAt(item, index);
+        return this;
+    }
+
+    virtual Sequence<T>* InsertAtInternal(T&& item, int index) override {
+        this->data = this->data.InsertAt(std::move(item), index);
+        return this;
+    }
+
+    // Gathers the element addresses in one walk, so node-based sources are not indexed per item.
+    static PersistentVector<T> collect(const Sequence<T>& other) {
+        DynamicArray<const T*> items;
+        items.Reserve(other.GetLength());
+        other.ForEachChunk([&items](const T* chunk, int count) {
+            for (int i = 0; i < count; ++i) {
+                items.EmplaceBack(chunk + i);
+            }
+            return true;
+        });
+        return PersistentVector<T>(items.GetSize(), [&items](int i) -> const T& { return *items.GetUnchecked(i); });
+    }
+
+    // The runs cannot take over the buffer's block, but its items are moved into them.
+    static PersistentVector<T> moveOut(DynamicArray<T>& buffer) {
+        return PersistentVector<T>(buffer.GetSize(), [&buffer](int i) -> T&& { return std::move(buffer.GetUnchecked(i)); });
+    }
+
+    virtual Sequence<T>* ConcatInternal(const Sequence<T>* other) override {
+        if (auto* persistent = dynamic_cast<const PersistentSequence<T>*>(other)) {
+            this->data = this->data.Concat(persistent->data);
+        } else {
+            this->data = this->data.Concat(collect(*other));
+        }
+        return this;
+    }
+
+    virtual Sequence<T>* RemoveAtInternal(int index) override {
+        this->data = this->data.RemoveAt(index);
+        return this;
+    }
+
+    virtual Sequence<T>* RemoveRangeInternal(int startIndex, int endIndex) override {
+        this->data = this->data.RemoveRange(startIndex, endIndex);
+        return this;
+    }
+
+    virtual Sequence<T>* RemoveIfInternal(const std::function<bool(const T&)>& predicate) override {
+        this->data = this->data.RemoveIf(predicate);
+        return this;
+    }
+
+protected:
+    virtual Sequence<T>* Instance() = 0;
+    virtual PersistentSequence<T>* CreateEmptyPersistentSequence() const = 0;
+
+public:
+    PersistentSequence() : data() {}
+    PersistentSequence(const T* items, int count) : data(items, count) {}
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    PersistentSequence(InputIterator first, InputIterator last) : data(first, last) {}
+    PersistentSequence(std::initializer_list<T> items) : data(items.begin(), static_cast<int>(items.size())) {}
+    explicit PersistentSequence(DynamicArray<T>&& buffer) : data(moveOut(buffer)) {}
+    PersistentSequence(const Sequence<T>& other) : data(collect(other)) {}
+    PersistentSequence(const PersistentSequence<T>& other) = default;
+    PersistentSequence(PersistentSequence<T>&& other) noexcept : data(std::move(other.data)) {}
+
+    // Elements may be shared with other versions, so only read-only iteration is offered.
+    using ConstIterator = typename PersistentVector<T>::ConstIterator;
+
+    ConstIterator begin() const {
+        return this->data.begin();
+    }
+
+    ConstIterator end() const {
+        return this->data.end();
+    }
+
+    template <typename Visitor>
+    bool VisitChunks(Visitor&& visitor) const {
+        return this->data.VisitChunks(std::forward<Visitor>(visitor));
+    }
+
+    bool ForEachChunk(const std::function<bool(const T*, int)>& visitor) const override {
+        return this->VisitChunks(visitor);
+    }
+
+    int GetLength() const override {
+        return this->data.GetSize();
+    }
+
+    const T& GetFirst() const override {
+        if (this->GetLength() == 0) {
+            throw std::out_of_range("Sequence is empty - cannot get first element");
+        }
+
+        return this->data.GetUnchecked(0);
+    }
+
+    const T& GetLast() const override {
+        if (this->GetLength() == 0) {
+            throw std::out_of_range("Sequence is empty - cannot get last element");
+        }
+
+        return this->data.GetUnchecked(this->data.GetSize() - 1);
+    }
+
+    const T& Get(int index) const override {
+        if (index < 0 || index >= this->data.GetSize()) {
+            throw std::out_of_range("Sequence index out of range");
+        }
+
+        return this->data.GetUnchecked(index);
+    }
+
+    const T& GetUnchecked(int index) const override {
+        return this->data.GetUnchecked(index);
+    }
+
+    T& GetFirst() override {
+        if (this->GetLength() == 0) {
+            throw std::out_of_range("Sequence is empty - cannot get first element");
+        }
+
+        return this->data[0];
+    }
+
+    T& GetLast() override {
+        if (this->GetLength() == 0) {
+            throw std::out_of_range("Sequence is empty - cannot get last element");
+        }
+
+        return this->data[this->data.GetSize() - 1];
+    }
+
+    T& Get(int index) override {
+        if (index < 0 || index >= this->data.GetSize()) {
+            throw std::out_of_range("Sequence index out of range");
+        }
+
+        return this->data[index];
+    }
+
+    // Writable access copies the nodes on the path that other versions still share.
+    T& GetUnchecked(int index) override {
+        return this->data[index];
+    }
+
+    T& operator[] (int index) override {
+        return this->Get(index);
+    }
+
+    Sequence<T>* CreateSequenceFrom(DynamicArray<T>&& buffer) const override {
+        PersistentSequence<T>* ret = this->CreateEmptyPersistentSequence();
+        ret->data = moveOut(buffer);
+        return ret;
+    }
+
+    PersistentSequence<T>* GetSubsequence(int startIndex, int endIndex) const override {
+        if (std::min(startIndex, endIndex) < 0 || std::max(startIndex, endIndex) >= this->data.GetSize()) {
+            throw std::out_of_range("Sequence index out of range");
+        }
+
+        PersistentSequence<T>* ret = this->CreateEmptyPersistentSequence();
+        ret->data = this->data.GetSubVector(startIndex, endIndex);
+
+        return ret;
+    }
+
+    virtual Sequence<T>* Append(const T& item) override {
+        return this->Instance()->AppendInternal(item);
+    }
+
+    virtual Sequence<T>* Append(T&& item) override {
+        return this->Instance()->AppendInternal(std::move(item));
+    }
+
+    virtual Sequence<T>* Prepend(const T& item) override {
+        return this->Instance()->PrependInternal(item);
+    }
+
+    virtual Sequence<T>* Prepend(T&& item) override {
+        return this->Instance()->PrependInternal(std::move(item));
+    }
+
+    virtual Sequence<T>* InsertAt(const T& item, int index) override {
+        if (index < 0 || index >= this->data.GetSize()) {
+            throw std::out_of_range("Sequence index out of range");
+        }
+        return this->Instance()->InsertAtInternal(item, index);
+    }
+
+    virtual Sequence<T>* InsertAt(T&& item, int index) override {
+        if (index < 0 || index >= this->data.GetSize()) {
+            throw std::out_of_range("Sequence index out of range");
+        }
+        return this->Instance()->InsertAtInternal(std::move(item), index);
+    }
+
     virtual Sequence<T>* Concat(const Sequence<T>* other) override {
         return this->Instance()->ConcatInternal(other);
     }
+
+    virtual Sequence<T>* RemoveAt(int index) override {
+        if (index < 0 || index >= this->data.GetSize()) {
+            throw std::out_of_range("Sequence index out of range");
+        }
+        return this->Instance()->RemoveAtInternal(index);
+    }
+
+    virtual Sequence<T>* RemoveRange(int startIndex, int endIndex) override {
+        if (std::min(startIndex, endIndex) < 0 || std::max(startIndex, endIndex) >= this->data.GetSize()) {
+            throw std::out_of_range("Sequence index out of range");
+        }
+        return this->Instance()->RemoveRangeInternal(std::min(startIndex, endIndex), std::max(startIndex, endIndex));
+    }
+
+    virtual Sequence<T>* RemoveIf(const std::function<bool(const T&)>& predicate) override {
+        return this->Instance()->RemoveIfInternal(predicate);
+    }
 };
 
 
@@ -444,18 +1334,29 @@ struct ImmutableSequenceTag {};
 
 
 template <typename T>
-class MutableArraySequence : public ArraySequence<T> {
+class MutableArraySequence final : public ArraySequence<T>, public StaticSequence<MutableArraySequence<T>, T> {
 public:
     using tag = MutableSequenceTag;
 
     MutableArraySequence() : ArraySequence<T>() {}
     MutableArraySequence(const T* items, int count) : ArraySequence<T>(items, count) {}
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    MutableArraySequence(InputIterator first, InputIterator last) : ArraySequence<T>(first, last) {}
+    MutableArraySequence(std::initializer_list<T> items) : ArraySequence<T>(items) {}
+    explicit MutableArraySequence(DynamicArray<T>&& buffer) : ArraySequence<T>(std::move(buffer)) {}
+    MutableArraySequence(const Sequence<T>& other) : ArraySequence<T>(other) {}
     MutableArraySequence(const ArraySequence<T>& other) : ArraySequence<T>(other) {}
     MutableArraySequence(ArraySequence<T>&& other) : ArraySequence<T>(std::move(other)) {}
 
     virtual Sequence<T>* CreateEmptySequence() const override { 
         return new MutableArraySequence<T>();
     }
+    virtual Sequence<T>* CreateSequence(const T* items, int count) const override {
+        return new MutableArraySequence<T>(items, count);
+    }
+    virtual Sequence<T>* CreateSequenceFrom(DynamicArray<T>&& buffer) const override {
+        return new MutableArraySequence<T>(std::move(buffer));
+    }
     virtual ArraySequence<T>* CreateEmptyArraySequence() const override {
         return new MutableArraySequence<T>();
     }
@@ -466,90 +1367,158 @@ public:
 
 
 template <typename T>
-class ImmutableArraySequence : public ArraySequence<T> {
+class ImmutableArraySequence final : public PersistentSequence<T>, public StaticSequence<ImmutableArraySequence<T>, T> {
 private:
-    ArraySequence<T>* Clone() const {
+    PersistentSequence<T>* Clone() const {
+        Instrument::Clone();
         return new ImmutableArraySequence<T>(*this);
     }
 
 public:
     using tag = ImmutableSequenceTag;
 
-    ImmutableArraySequence() : ArraySequence<T>() {}
-    ImmutableArraySequence(const T* items, int count) : ArraySequence<T>(items, count) {}
-    ImmutableArraySequence(const Sequence<T>& other) : ArraySequence<T>(other) {}
-    ImmutableArraySequence(ArraySequence<T>&& other) : ArraySequence<T>(std::move(other)) {}
+    ImmutableArraySequence() : PersistentSequence<T>() {}
+    ImmutableArraySequence(const T* items, int count) : PersistentSequence<T>(items, count) {}
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    ImmutableArraySequence(InputIterator first, InputIterator last) : PersistentSequence<T>(first, last) {}
+    ImmutableArraySequence(std::initializer_list<T> items) : PersistentSequence<T>(items) {}
+    explicit ImmutableArraySequence(DynamicArray<T>&& buffer) : PersistentSequence<T>(std::move(buffer)) {}
+    ImmutableArraySequence(const Sequence<T>& other) : PersistentSequence<T>(other) {}
+    ImmutableArraySequence(const ImmutableArraySequence<T>& other) : PersistentSequence<T>(other) {}
+    ImmutableArraySequence(ImmutableArraySequence<T>&& other) noexcept : PersistentSequence<T>(std::move(other)) {}
 
     virtual Sequence<T>* CreateEmptySequence() const override { 
         return new ImmutableArraySequence<T>();
     }
-    virtual ArraySequence<T>* CreateEmptyArraySequence() const override {
+    virtual Sequence<T>* CreateSequence(const T* items, int count) const override {
+        return new ImmutableArraySequence<T>(items, count);
+    }
+    virtual PersistentSequence<T>* CreateEmptyPersistentSequence() const override {
         return new ImmutableArraySequence<T>();
     }
-    virtual ArraySequence<T>* Instance() override {
+    virtual PersistentSequence<T>* Instance() override {
         return Clone();
     }
 };
 
 
 template <typename T>
-class MutableListSequence : public ListSequence<T> {
+class MutableListSequence final : public ListSequence<T>, public StaticSequence<MutableListSequence<T>, T> {
 public:
     using tag = MutableSequenceTag;
 
     MutableListSequence() : ListSequence<T>() {}
     MutableListSequence(const T* items, int count) : ListSequence<T>(items, count) {}
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    MutableListSequence(InputIterator first, InputIterator last) : ListSequence<T>(first, last) {}
+    MutableListSequence(std::initializer_list<T> items) : ListSequence<T>(items) {}
     MutableListSequence(const Sequence<T>& other) : ListSequence<T>(other) {}
     MutableListSequence(ListSequence<T>&& other) : ListSequence<T>(std::move(other)) {}
 
     virtual Sequence<T>* CreateEmptySequence() const override { 
         return new MutableListSequence<T>();
     }
+    virtual Sequence<T>* CreateSequence(const T* items, int count) const override {
+        return new MutableListSequence<T>(items, count);
+    }
     virtual ListSequence<T>* CreateEmptyListSequence() const override {
         return new MutableListSequence<T>();
     }
     virtual ListSequence<T>* Instance() override {
         return this;
     }
+
+    // Splices relink list nodes instead of copying them; `other` loses the moved elements.
+    MutableListSequence<T>* ConcatMove(MutableListSequence<T>& other) {
+        this->data->ConcatMove(*other.data);
+        return this;
+    }
+
+    MutableListSequence<T>* SpliceRange(int index, MutableListSequence<T>& other, int startIndex, int endIndex) {
+        this->data->SpliceRange(index, *other.data, startIndex, endIndex);
+        return this;
+    }
+
+    // Keeps [0, index) and returns the rest as a new sequence.
+    MutableListSequence<T>* SplitAt(int index) {
+        LinkedList<T>* rest = this->data->SplitAt(index);
+        MutableListSequence<T>* ret = new MutableListSequence<T>();
+        delete ret->data;
+        ret->data = rest;
+        return ret;
+    }
 };
 
 
 template <typename T>
-class ImmutableListSequence : public ListSequence<T> {
+class ImmutableListSequence final : public PersistentSequence<T>, public StaticSequence<ImmutableListSequence<T>, T> {
 private:
-    ListSequence<T>* Clone() const {
+    PersistentSequence<T>* Clone() const {
+        Instrument::Clone();
         return new ImmutableListSequence<T>(*this);
     }
 
 public:
     using tag = ImmutableSequenceTag;
 
-    ImmutableListSequence() : ListSequence<T>() {}
-    ImmutableListSequence(const T* items, int count) : ListSequence<T>(items, count) {}
-    ImmutableListSequence(const Sequence<T>& other) : ListSequence<T>(other) {}
-    ImmutableListSequence(ListSequence<T>&& other) : ListSequence<T>(std::move(other)) {}
-    ImmutableListSequence(const ImmutableListSequence<T>& other) : ListSequence<T>(other) {}
+    ImmutableListSequence() : PersistentSequence<T>() {}
+    ImmutableListSequence(const T* items, int count) : PersistentSequence<T>(items, count) {}
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    ImmutableListSequence(InputIterator first, InputIterator last) : PersistentSequence<T>(first, last) {}
+    ImmutableListSequence(std::initializer_list<T> items) : PersistentSequence<T>(items) {}
+    ImmutableListSequence(const Sequence<T>& other) : PersistentSequence<T>(other) {}
+    ImmutableListSequence(const ImmutableListSequence<T>& other) : PersistentSequence<T>(other) {}
+    ImmutableListSequence(ImmutableListSequence<T>&& other) noexcept : PersistentSequence<T>(std::move(other)) {}
 
     virtual Sequence<T>* CreateEmptySequence() const override { 
         return new ImmutableListSequence<T>();
     }
-    virtual ListSequence<T>* CreateEmptyListSequence() const override {
+    virtual Sequence<T>* CreateSequence(const T* items, int count) const override {
+        return new ImmutableListSequence<T>(items, count);
+    }
+    virtual PersistentSequence<T>* CreateEmptyPersistentSequence() const override {
         return new ImmutableListSequence<T>();
     }
-    virtual ListSequence<T>* Instance() override {
+    virtual PersistentSequence<T>* Instance() override {
         return Clone();
     }
 };
 
 
+// Builds a new SequenceType from anything with begin/end, such as a standard container or
+// another sequence. Extra arguments (e.g. a segment size) go after the range.
+template <typename SequenceType, typename Range, typename... Args>
+SequenceType* makeSequence(const Range& range, Args&&... args) {
+    return new SequenceType(std::begin(range), std::end(range), std::forward<Args>(args)...);
+}
+
+template <typename SequenceType, typename T, typename... Args>
+SequenceType* makeSequence(std::initializer_list<T> items, Args&&... args) {
+    return new SequenceType(items, std::forward<Args>(args)...);
+}
+
+
 template <typename T1, typename T2>
 Sequence<std::pair<T1, T2>>* zip(const Sequence<T1>* seq1, const Sequence<T2>* seq2) {
     int min_length = std::min(seq1->GetLength(), seq2->GetLength());
     auto* result = new MutableArraySequence<std::pair<T1, T2>>();
 
-    for (int i = 0; i < min_length; ++i) {
-        result->Append(std::make_pair(seq1->Get(i), seq2->Get(i)));
-    }
+    DynamicArray<const T2*> second;
+    second.Reserve(min_length);
+    seq2->ForEachChunk([&second, min_length](const T2* items, int count) {
+        for (int i = 0; i < count && second.GetSize() < min_length; ++i) {
+            second.EmplaceBack(items + i);
+        }
+        return second.GetSize() < min_length;
+    });
+
+    int index = 0;
+    seq1->ForEachChunk([&](const T1* items, int count) {
+        for (int i = 0; i < count && index < min_length; ++i, ++index) {
+            result->Append(std::make_pair(items[i], *second.GetUnchecked(index)));
+        }
+        return index < min_length;
+    });
 
     return result;
 }
@@ -3,6 +3,10 @@
 #include "SegmentedSequence.hpp"
 #include <functional>
 #include "AdaptiveSequence.hpp"
+#include "UnrolledListSequence.hpp"
+#include "SequenceView.hpp"
+#include <vector>
+#include <algorithm>
 
 
 class ManualSequenceTester {
@@ -25,6 +29,16 @@ public:
     }
 
 private:
+    // Immutable operations return a new version; the one it replaces is deleted unless it
+    // is `kept`, which belongs to the caller.
+    template <typename T>
+    static void advance(Sequence<T>*& current, Sequence<T>* next, const Sequence<T>* kept = nullptr) {
+        if (current != next && current != kept) {
+            delete current;
+        }
+        current = next;
+    }
+
     template <typename T>
     std::string printSequence(Sequence<T>* seq) {
         if (auto* segSeq = dynamic_cast<SegmentedSequence<T>*>(seq)) {
@@ -54,7 +68,7 @@ private:
         int implChoice;
         std::cin >> implChoice;
     
-        if(implChoice == 9) {
+        if(implChoice == 11) {
             testNestedSequences<T>();
             return;
         }
@@ -73,19 +87,20 @@ private:
         std::cout << "\n=== Testing ===\n";
     
         printTestResult(seq->GetLength() == 0, "Initial length is 0");
+        Sequence<T>* original = seq;
 
         T sample1 = getSampleValue<T>(0);
-        seq = seq->Append(sample1);
+        advance(seq, seq->Append(sample1), original);
         printTestResult(seq->GetLength() == 1, "Length after append");
         printTestResult(seq->GetLast() == sample1, "GetLast() after append");
 
         T sample2 = getSampleValue<T>(1);
-        seq = seq->Prepend(sample2);
+        advance(seq, seq->Prepend(sample2), original);
         printTestResult(seq->GetFirst() == sample2, "GetFirst() after prepend");
 
         T sample3 = getSampleValue<T>(2);
-        seq = seq->InsertAt(sample3, 1);
-        seq = seq->InsertAt(sample3, 1);
+        advance(seq, seq->InsertAt(sample3, 1), original);
+        advance(seq, seq->InsertAt(sample3, 1), original);
         printTestResult(seq->Get(1) == sample3, "InsertAt middle position");
 
         Sequence<T>* mapped = seq->Map(getMapFunction<T>());
@@ -107,8 +122,14 @@ private:
 
         T sample4 = getSampleValue<T>(1);
         int len = seq->GetLength();
-        seq->Append(sample4);
+        Sequence<T>* appended = seq->Append(sample4);
         printTestResult(seq->GetLength() == len + choice % 2, "Mutable/Immutable test");
+        if (appended != seq) delete appended;
+
+        len = seq->GetLength();
+        Sequence<T>* shorter = seq->RemoveAt(0);
+        printTestResult(shorter->GetLength() == len - 1 && seq->GetLength() == len - choice % 2, "RemoveAt keeps mutability");
+        if (shorter != seq) delete shorter;
 
         T* arr = new T[3];
         arr[0] = sample1;
@@ -118,6 +139,237 @@ private:
         printTestResult(seq2->GetLength() == 3, "Created MutableArraySequence from array");
         delete[] arr;
         delete seq2;
+
+        if (seq != original) delete seq;
+
+        testWritesThroughVersions<T>(choice);
+        testRemovalEdges<T>(choice);
+        testViews<T>(choice);
+        testParallel<T>(choice);
+        testRelinking<T>(choice);
+    }
+
+    // Immutable versions share storage, so a write through a derived one must not reach the original.
+    template <typename T>
+    void testWritesThroughVersions(int choice) {
+        Sequence<T>* original = createNumbered<T>(choice, 0, 3);
+        Sequence<T>* derived = original->Append(getNumberedValue<T>(3));
+        derived->Get(0) = getNumberedValue<T>(7);
+        (*derived)[1] = getNumberedValue<T>(8);
+        derived->GetLast() = getNumberedValue<T>(9);
+        if (derived != original) {
+            printTestResult(holdsNumbers(original, {0, 1, 2}) && holdsNumbers(derived, {7, 8, 2, 9}),
+                            "Writes through a derived version leave the original unchanged");
+            delete derived;
+        } else {
+            printTestResult(holdsNumbers(original, {7, 8, 2, 9}), "Writes through Get and operator[] are visible");
+        }
+        delete original;
+    }
+
+    template <typename T>
+    void testRemovalEdges(int choice) {
+        Sequence<T>* seq = createNumbered<T>(choice, 0, 8);
+        advance(seq, seq->RemoveAt(0));
+        advance(seq, seq->RemoveAt(seq->GetLength() - 1));
+        printTestResult(holdsNumbers(seq, {1, 2, 3, 4, 5, 6}), "RemoveAt first and last index");
+
+        advance(seq, seq->RemoveRange(0, 1));
+        advance(seq, seq->RemoveRange(3, 2));
+        printTestResult(holdsNumbers(seq, {3, 4}), "RemoveRange at the front and reversed at the back");
+
+        printTestResult(throwsOutOfRange([seq] { seq->RemoveAt(seq->GetLength()); }), "RemoveAt(length) throws");
+        printTestResult(throwsOutOfRange([seq] { seq->RemoveRange(-1, 0); }), "RemoveRange(-1, 0) throws");
+
+        advance(seq, seq->RemoveRange(0, seq->GetLength() - 1));
+        printTestResult(seq->GetLength() == 0, "RemoveRange over the whole sequence");
+        advance(seq, seq->Append(getNumberedValue<T>(9)));
+        printTestResult(holdsNumbers(seq, {9}), "Append after removing everything");
+        delete seq;
+    }
+
+    template <typename T>
+    void testViews(int choice) {
+        Sequence<T>* seq = createNumbered<T>(choice, 0, 10);
+        SequenceView<T> whole(*seq);
+        SequenceView<T> strided(*seq, 1, 9, 3);
+        printTestResult(viewHolds(whole.Reversed(), {9, 8, 7, 6, 5, 4, 3, 2, 1, 0}), "Reversed view");
+        printTestResult(viewHolds(strided, {1, 4, 7}), "Strided view");
+        printTestResult(viewHolds(strided.Reversed(), {7, 4, 1}), "Reversed strided view");
+        printTestResult(viewHolds(SequenceView<T>(*seq, 9, 0).GetSubview(1, 7, 2), {8, 6, 4, 2}),
+                        "Strided subview of a backwards view");
+        printTestResult(viewHolds(whole.GetSubview(2, 8, 2).GetSubview(3, 1), {8, 6, 4}), "Reversed subview of a subview");
+        delete seq;
+
+        // Long enough that indexing a list-backed view item by item would be quadratic.
+        Sequence<T>* longSeq = createNumbered<T>(choice, 0, 20000);
+        std::vector<int> everyThird;
+        for (int i = 19999; i >= 100; i -= 3) {
+            everyThird.push_back(i);
+        }
+        printTestResult(viewHolds(SequenceView<T>(*longSeq, 19999, 100, 3), everyThird), "Reversed strided view over a long sequence");
+        std::vector<int> middle = range(50, 19950);
+        std::reverse(middle.begin(), middle.end());
+        printTestResult(viewHolds(SequenceView<T>(*longSeq).GetSubview(50, 19949).Reversed(), middle), "Reversed subview over a long sequence");
+        delete longSeq;
+    }
+
+    // Small grains force the pieces to split the data even at this length.
+    template <typename T>
+    void testParallel(int choice) {
+        Sequence<T>* seq = createNumbered<T>(choice, 0, 2000);
+        ThreadPool pool(4);
+        ParallelPolicy policy;
+        policy.pool = &pool;
+        policy.minLength = 64;
+        policy.minGrain = 16;
+
+        Sequence<T>* kept = seq->Where(policy, [this](const T& item) { return numberOf(item) % 3 == 0; });
+        std::vector<int> multiples;
+        for (int i = 0; i < 2000; i += 3) {
+            multiples.push_back(i);
+        }
+        printTestResult(holdsNumbers(kept, multiples), "Parallel Where keeps the matches in order");
+        delete kept;
+
+        Sequence<T>* mapped = seq->Map(policy, getMapFunction<T>());
+        Sequence<T>* expected = seq->Map(getMapFunction<T>());
+        printTestResult(sameItems(mapped, expected), "Parallel Map matches sequential Map");
+        delete mapped;
+        delete expected;
+        delete seq;
+    }
+
+    // Only the mutable list and segmented sequences can hand nodes or segments to each other.
+    template <typename T>
+    void testRelinking(int choice) {
+        if (choice == 3) {
+            MutableListSequence<T> first, second, third;
+            appendNumbers(first, 0, 5);
+            appendNumbers(second, 5, 10);
+            appendNumbers(third, 10, 15);
+
+            first.ConcatMove(second);
+            printTestResult(holdsNumbers(&first, range(0, 10)) && second.GetLength() == 0, "ConcatMove relinks every node");
+
+            first.SpliceRange(2, third, 1, 3);
+            printTestResult(holdsNumbers(&first, {0, 1, 11, 12, 13, 2, 3, 4, 5, 6, 7, 8, 9}) && holdsNumbers(&third, {10, 14}),
+                            "SpliceRange moves a middle range");
+
+            MutableListSequence<T>* rest = first.SplitAt(5);
+            printTestResult(holdsNumbers(&first, {0, 1, 11, 12, 13}) && holdsNumbers(rest, range(2, 10)), "SplitAt keeps the front");
+
+            // The lists now share one merged node pool: deleting one must not release it,
+            // and the slots it frees are reused by the others.
+            delete rest;
+            appendNumbers(third, 15, 20);
+            printTestResult(holdsNumbers(&first, {0, 1, 11, 12, 13}) && holdsNumbers(&third, {10, 14, 15, 16, 17, 18, 19}),
+                            "Merged pool survives deleting one list");
+        } else if (choice == 5) {
+            MutableSegmentedSequence<T> front(3), back(3);
+            appendNumbers(front, 0, 7);
+            appendNumbers(back, 7, 12);
+
+            front.ConcatMove(back);
+            printTestResult(holdsNumbers(&front, range(0, 12)) && back.GetLength() == 0, "ConcatMove relinks segments");
+
+            MutableSegmentedSequence<T>* rest = front.SplitAt(4);
+            printTestResult(holdsNumbers(&front, {0, 1, 2, 3}) && holdsNumbers(rest, range(4, 12)), "SplitAt inside a segment");
+            delete rest;
+
+            MutableSegmentedSequence<T> sparse(8);
+            appendNumbers(sparse, 0, 32);
+            sparse.RemoveRange(1, 29);
+            printTestResult(holdsNumbers(&sparse, {0, 30, 31}) && sparse.GetSegmentsLength() == 1,
+                            "Short segments merge after RemoveRange");
+        }
+    }
+
+    // Item i of a numbered sequence is getNumberedValue<T>(i), so order checks read as lists of numbers.
+    template <typename T>
+    Sequence<T>* createNumbered(int choice, int from, int to) {
+        Sequence<T>* seq = createSequence<T>(choice);
+        for (int i = from; i < to; ++i) {
+            advance(seq, seq->Append(getNumberedValue<T>(i)));
+        }
+        return seq;
+    }
+
+    template <typename S>
+    void appendNumbers(S& seq, int from, int to) {
+        for (int i = from; i < to; ++i) {
+            seq.Append(getNumberedValue<typename S::value_type>(i));
+        }
+    }
+
+    static std::vector<int> range(int from, int to) {
+        std::vector<int> ret;
+        for (int i = from; i < to; ++i) {
+            ret.push_back(i);
+        }
+        return ret;
+    }
+
+    template <typename T>
+    bool holdsNumbers(const Sequence<T>* seq, const std::vector<int>& numbers) {
+        if (seq->GetLength() != static_cast<int>(numbers.size())) {
+            return false;
+        }
+        int index = 0;
+        for (const T& item : *seq) {
+            if (!(item == getNumberedValue<T>(numbers[index++]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename T>
+    bool viewHolds(const SequenceView<T>& view, const std::vector<int>& numbers) {
+        bool indexed = view.GetLength() == static_cast<int>(numbers.size());
+        for (int i = 0; indexed && i < view.GetLength(); ++i) {
+            indexed = view.Get(i) == getNumberedValue<T>(numbers[i]);
+        }
+        int walked = 0;
+        bool iterated = true;
+        for (const T& item : view) {
+            iterated = iterated && walked < view.GetLength() && item == getNumberedValue<T>(numbers[walked]);
+            ++walked;
+        }
+        iterated = iterated && walked == view.GetLength();
+        typename SequenceView<T>::ConstIterator back = view.end();
+        for (int i = view.GetLength() - 1; iterated && i >= 0; --i) {
+            --back;
+            iterated = *back == getNumberedValue<T>(numbers[i]);
+        }
+        Sequence<T>* copy = view.Materialize();
+        bool materialized = holdsNumbers(copy, numbers);
+        delete copy;
+        return indexed && iterated && materialized;
+    }
+
+    template <typename T>
+    static bool sameItems(const Sequence<T>* first, const Sequence<T>* second) {
+        if (first->GetLength() != second->GetLength()) {
+            return false;
+        }
+        for (int i = 0; i < first->GetLength(); ++i) {
+            if (!(first->Get(i) == second->Get(i))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename F>
+    static bool throwsOutOfRange(F action) {
+        try {
+            action();
+        } catch (const std::out_of_range&) {
+            return true;
+        } catch (...) {
+        }
+        return false;
     }
 
     template <typename T>
@@ -143,9 +395,9 @@ private:
         for(int i = 0; i < 3; i++) {
             InnerSeq innerSeq = createSequence<T>(innerChoice);
             for(int j = 0; j < 3; j++) {
-                innerSeq = innerSeq->Append(getSampleValue<T>(i*3 + j));
+                advance(innerSeq, innerSeq->Append(getSampleValue<T>(i*3 + j)));
             }
-            outerSeq = outerSeq->Append(innerSeq);
+            advance(outerSeq, outerSeq->Append(innerSeq));
         }
         
         std::cout << "Nested sequence structure:\n";
@@ -171,6 +423,18 @@ private:
         return T();
     }
 
+    template <typename T>
+    T getNumberedValue(int number) {
+        static_assert(sizeof(T) == 0, "Not implemented for this type");
+        return T();
+    }
+
+    template <typename T>
+    int numberOf(const T& item) {
+        static_assert(sizeof(T) == 0, "Not implemented for this type");
+        return 0;
+    }
+
     template <typename T>
     std::function<T(T)> getMapFunction() {
         static_assert(sizeof(T) == 0, "Not implemented for this type");
@@ -202,7 +466,9 @@ private:
         << "6. ImmutableSegmentedSequence\n"
         << "7. MutableAdaptiveSequence\n"
         << "8. ImmutableAdaptiveSequence\n"
-        << "9. Test nested sequences\n"
+        << "9. MutableUnrolledListSequence\n"
+        << "10. ImmutableUnrolledListSequence\n"
+        << "11. Test nested sequences\n"
         << "Your choice: ";
     }
     void printImplementation2Menu() {
@@ -231,9 +497,11 @@ private:
             case 3: return new MutableListSequence<T>();
             case 4: return new ImmutableListSequence<T>();
             case 5: return new MutableSegmentedSequence<T>(3);
-            case 6: return new ImmutableSegmentedSequence<T>(3);
+            case 6: return new ImmutableSegmentedSequence<T>();
             case 7: return new MutableAdaptiveSequence<T>();
             case 8: return new ImmutableAdaptiveSequence<T>();
+            case 9: return new MutableUnrolledListSequence<T>();
+            case 10: return new ImmutableUnrolledListSequence<T>();
             default: return nullptr;
         }
     }
@@ -280,6 +548,36 @@ inline std::string ManualSequenceTester::getSampleValue<std::string>(size_t inde
     return samples[index % 3];
 }
 
+template <>
+inline int ManualSequenceTester::getNumberedValue<int>(int number) {
+    return number;
+}
+
+template <>
+inline double ManualSequenceTester::getNumberedValue<double>(int number) {
+    return number + 0.5;
+}
+
+template <>
+inline std::string ManualSequenceTester::getNumberedValue<std::string>(int number) {
+    return std::to_string(number);
+}
+
+template <>
+inline int ManualSequenceTester::numberOf<int>(const int& item) {
+    return item;
+}
+
+template <>
+inline int ManualSequenceTester::numberOf<double>(const double& item) {
+    return static_cast<int>(item);
+}
+
+template <>
+inline int ManualSequenceTester::numberOf<std::string>(const std::string& item) {
+    return std::stoi(item);
+}
+
 template <>
 inline std::function<int(int)> ManualSequenceTester::getMapFunction<int>() {
     return [](int x) {
@@ -0,0 +1,351 @@
+#pragma once
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include "Sequence.hpp"
+
+
+// Non-owning window over a sequence or over contiguous storage: `count` elements starting
+// at position `start` and `stride` apart, walking backwards when the stride is negative.
+// Nothing is copied until Materialize, Map or Where builds a result, and any change to
+// the underlying sequence or storage invalidates the view. A sequence stored in several
+// runs is walked once when the view is made, to record the runs that cover it; subviews
+// share that table and move through it run by run instead of indexing the sequence.
+template <typename T>
+class SequenceView {
+private:
+    struct Run {
+        const T* items;
+        int count;
+        int offset;
+    };
+
+    // Position runs[run].offset + offset of the sequence; offset leaves [0, count) only
+    // past either end of the table.
+    struct Cursor {
+        int run;
+        int offset;
+    };
+
+    using Runs = DynamicArray<Run>;
+
+    const Sequence<T>* sequence;
+    const T* items;
+    std::shared_ptr<const Runs> runs;
+    int start;
+    int count;
+    int stride;
+
+    SequenceView(const Sequence<T>* sequence_, const T* items_, const std::shared_ptr<const Runs>& runs_,
+                 int start_, int count_, int stride_)
+        : sequence(sequence_), items(items_), runs(runs_), start(start_), count(count_), stride(stride_) {}
+
+    // Ranges follow GetSubsequence: both ends are included and startIndex > endIndex runs backwards.
+    static void _checkRange(int length, int startIndex, int endIndex, int step) {
+        if (std::min(startIndex, endIndex) < 0 || std::max(startIndex, endIndex) >= length) {
+            throw std::out_of_range("Invalid view range");
+        }
+        if (step <= 0) {
+            throw std::invalid_argument("View stride must be positive");
+        }
+    }
+
+    static int _countOf(int startIndex, int endIndex, int step) {
+        int distance = startIndex <= endIndex ? endIndex - startIndex : startIndex - endIndex;
+        return distance / step + 1;
+    }
+
+    // A sequence that reports all of its elements as one run can be indexed directly.
+    static const T* _contiguous(const Sequence<T>& seq) {
+        const T* ret = nullptr;
+        int length = seq.GetLength();
+        seq.ForEachChunk([&ret, length](const T* chunk, int chunkLength) {
+            if (chunkLength == length) {
+                ret = chunk;
+            }
+            return false;
+        });
+        return ret;
+    }
+
+    // Records the runs of seq that overlap positions [first, last].
+    static std::shared_ptr<const Runs> _runsOf(const Sequence<T>& seq, int first, int last) {
+        auto ret = std::make_shared<Runs>();
+        int offset = 0;
+        seq.ForEachChunk([&ret, &offset, first, last](const T* chunk, int chunkLength) {
+            if (chunkLength > 0 && offset + chunkLength > first) {
+                ret->EmplaceBack(Run{chunk, chunkLength, offset});
+            }
+            offset += chunkLength;
+            return offset <= last;
+        });
+        return ret;
+    }
+
+    Cursor _locate(int position) const {
+        const Run* first = runs->begin();
+        const Run* last = runs->end();
+        if (first == last) {
+            return Cursor{0, position};
+        }
+        const Run* run = std::upper_bound(first + 1, last, position, [](int value, const Run& r) {
+            return value < r.offset;
+        }) - 1;
+        return Cursor{static_cast<int>(run - first), position - run->offset};
+    }
+
+    void _advance(Cursor& cursor, int by) const {
+        const Run* run = runs->begin();
+        int last = runs->GetSize() - 1;
+        cursor.offset += by;
+        while (cursor.offset >= run[cursor.run].count && cursor.run < last) {
+            cursor.offset -= run[cursor.run].count;
+            ++cursor.run;
+        }
+        while (cursor.offset < 0 && cursor.run > 0) {
+            --cursor.run;
+            cursor.offset += run[cursor.run].count;
+        }
+    }
+
+    const T& _at(const Cursor& cursor) const {
+        return runs->GetUnchecked(cursor.run).items[cursor.offset];
+    }
+
+    const T& _at(int index) const {
+        int position = start + index * stride;
+        return items != nullptr ? items[position] : _at(_locate(position));
+    }
+
+    // Unit strides hand over whole runs; longer ones step the cursor from item to item.
+    template <typename Visitor>
+    void _forEach(Visitor&& visitor) const {
+        if (items != nullptr) {
+            const T* current = items + start;
+            for (int i = 0; i < count; ++i, current += stride) {
+                visitor(*current);
+            }
+            return;
+        }
+        if (count == 0) {
+            return;
+        }
+
+        Cursor cursor = _locate(start);
+        if (stride == 1 || stride == -1) {
+            for (int left = count; left > 0; ) {
+                const Run& run = runs->GetUnchecked(cursor.run);
+                int take = std::min(left, stride == 1 ? run.count - cursor.offset : cursor.offset + 1);
+                for (int i = 0; i < take; ++i) {
+                    visitor(run.items[cursor.offset + i * stride]);
+                }
+                left -= take;
+                _advance(cursor, take * stride);
+            }
+            return;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            visitor(_at(cursor));
+            if (i + 1 < count) {
+                _advance(cursor, stride);
+            }
+        }
+    }
+
+    template <typename U>
+    Sequence<U>* _create(DynamicArray<U>&& buffer) const {
+        if (sequence != nullptr) {
+            return sequence->CreateMapped(std::move(buffer));
+        }
+        return new MutableArraySequence<U>(std::move(buffer));
+    }
+
+public:
+    // Over runs the iterator carries a cursor, so each step moves by the stride through
+    // the run table instead of searching it again.
+    class ConstIterator {
+    private:
+        const SequenceView<T>* view;
+        int index;
+        Cursor cursor;
+
+        void _step(int by) {
+            index += by;
+            if (view->items == nullptr) {
+                view->_advance(cursor, by * view->stride);
+            }
+        }
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        ConstIterator() : view(nullptr), index(0), cursor{0, 0} {}
+        ConstIterator(const SequenceView<T>* view_, int index_) : view(view_), index(index_), cursor{0, 0} {
+            if (view->items == nullptr && view->runs != nullptr) {
+                cursor = view->_locate(view->start + index * view->stride);
+            }
+        }
+
+        reference operator*() const {
+            return view->items != nullptr ? view->_at(index) : view->_at(cursor);
+        }
+
+        pointer operator->() const {
+            return &**this;
+        }
+
+        ConstIterator& operator++() {
+            _step(1);
+            return *this;
+        }
+
+        ConstIterator operator++(int) {
+            ConstIterator ret = *this;
+            _step(1);
+            return ret;
+        }
+
+        ConstIterator& operator--() {
+            _step(-1);
+            return *this;
+        }
+
+        ConstIterator operator--(int) {
+            ConstIterator ret = *this;
+            _step(-1);
+            return ret;
+        }
+
+        bool operator==(const ConstIterator& other) const {
+            return index == other.index;
+        }
+
+        bool operator!=(const ConstIterator& other) const {
+            return index != other.index;
+        }
+    };
+
+    SequenceView() : sequence(nullptr), items(nullptr), runs(), start(0), count(0), stride(1) {}
+
+    SequenceView(const Sequence<T>& seq)
+        : sequence(&seq), items(_contiguous(seq)), runs(), start(0), count(seq.GetLength()), stride(1) {
+        if (items == nullptr) {
+            runs = _runsOf(seq, 0, count - 1);
+        }
+    }
+
+    SequenceView(const Sequence<T>& seq, int startIndex, int endIndex, int step = 1)
+        : sequence(&seq), items(nullptr), runs(), start(startIndex), count(0), stride(startIndex <= endIndex ? step : -step) {
+        _checkRange(seq.GetLength(), startIndex, endIndex, step);
+        count = _countOf(startIndex, endIndex, step);
+        items = _contiguous(seq);
+        if (items == nullptr) {
+            runs = _runsOf(seq, std::min(startIndex, endIndex), std::max(startIndex, endIndex));
+        }
+    }
+
+    SequenceView(const T* items_, int count_)
+        : sequence(nullptr), items(items_), runs(), start(0), count(count_), stride(1) {}
+
+    SequenceView(const T* items_, int count_, int startIndex, int endIndex, int step = 1)
+        : sequence(nullptr), items(items_), runs(), start(startIndex), count(0), stride(startIndex <= endIndex ? step : -step) {
+        _checkRange(count_, startIndex, endIndex, step);
+        count = _countOf(startIndex, endIndex, step);
+    }
+
+    int GetLength() const {
+        return count;
+    }
+
+    const T& Get(int index) const {
+        if (index < 0 || index >= count) {
+            throw std::out_of_range("View index out of range");
+        }
+        return _at(index);
+    }
+
+    const T& operator[](int index) const {
+        return Get(index);
+    }
+
+    const T& GetFirst() const {
+        if (count == 0) throw std::out_of_range("View is empty");
+        return _at(0);
+    }
+
+    const T& GetLast() const {
+        if (count == 0) throw std::out_of_range("View is empty");
+        return _at(count - 1);
+    }
+
+    // Indices are relative to this view, so windows compose without touching the source.
+    SequenceView<T> GetSubview(int startIndex, int endIndex, int step = 1) const {
+        _checkRange(count, startIndex, endIndex, step);
+        int direction = startIndex <= endIndex ? 1 : -1;
+        return SequenceView<T>(sequence, items, runs, start + startIndex * stride,
+                               _countOf(startIndex, endIndex, step), stride * step * direction);
+    }
+
+    SequenceView<T> Reversed() const {
+        if (count == 0) {
+            return *this;
+        }
+        return SequenceView<T>(sequence, items, runs, start + (count - 1) * stride, count, -stride);
+    }
+
+    ConstIterator begin() const {
+        return ConstIterator(this, 0);
+    }
+
+    ConstIterator end() const {
+        return ConstIterator(this, count);
+    }
+
+    // Copies the viewed elements into a new sequence of the viewed kind, or a mutable array
+    // sequence when the view is over raw storage.
+    Sequence<T>* Materialize() const {
+        DynamicArray<T> buffer;
+        buffer.Reserve(count);
+        _forEach([&buffer](const T& item) {
+            buffer.EmplaceBack(item);
+        });
+        return _create(std::move(buffer));
+    }
+
+    template <typename F, typename U = std::decay_t<std::invoke_result_t<F&, const T&>>>
+    Sequence<U>* Map(F mapper) const {
+        DynamicArray<U> buffer;
+        buffer.Reserve(count);
+        _forEach([&mapper, &buffer](const T& item) {
+            buffer.EmplaceBack(mapper(item));
+        });
+        return _create(std::move(buffer));
+    }
+
+    template <typename F, typename = std::enable_if_t<std::is_invocable_r_v<bool, F&, const T&>>>
+    Sequence<T>* Where(F wherer) const {
+        DynamicArray<T> buffer;
+        _forEach([&wherer, &buffer](const T& item) {
+            if (wherer(item)) {
+                buffer.EmplaceBack(item);
+            }
+        });
+        return _create(std::move(buffer));
+    }
+
+    template <typename F, typename = std::enable_if_t<std::is_invocable_r_v<T, F&, const T&, const T&>>>
+    T Reduce(F reducer, const T& startVal) const {
+        T accumulator = startVal;
+        _forEach([&reducer, &accumulator](const T& item) {
+            accumulator = reducer(accumulator, item);
+        });
+        return accumulator;
+    }
+};
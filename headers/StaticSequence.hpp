@@ -0,0 +1,72 @@
+#pragma once
+#include <type_traits>
+#include <utility>
+
+
+// Compile-time counterpart of Sequence<T>. Every Mutable* and Immutable* sequence derives
+// from StaticSequence<itself, T> and is final: final is what lets the compiler bind the
+// virtual GetLength, Get and GetUnchecked statically, and it means those classes can no
+// longer be derived from. A Sequence<T>* still dispatches at run time.
+//
+// The static interface is the set of members below. Derived provides GetLength(),
+// Get(int), GetUnchecked(int) and a template VisitChunks(visitor) that calls
+// visitor(const T* items, int count) for each run of storage and stops once it returns
+// false. The forwarders carry their own names because the Sequence<T> branch of
+// Derived already declares GetLength and Get.
+template <typename Derived, typename T>
+class StaticSequence {
+private:
+    const Derived& self() const {
+        return static_cast<const Derived&>(*this);
+    }
+
+public:
+    int Length() const {
+        return self().GetLength();
+    }
+
+    const T& At(int index) const {
+        return self().Get(index);
+    }
+
+    const T& AtUnchecked(int index) const {
+        return self().GetUnchecked(index);
+    }
+
+    template <typename Visitor>
+    bool VisitRuns(Visitor&& visitor) const {
+        return self().VisitChunks(std::forward<Visitor>(visitor));
+    }
+
+    // ForEach without std::function: the visitor is inlined into the walk over each run.
+    template <typename Visitor>
+    void Visit(Visitor&& visitor) const {
+        VisitRuns([&visitor](const T* items, int count) {
+            for (int i = 0; i < count; ++i) {
+                visitor(items[i]);
+            }
+            return true;
+        });
+    }
+
+    template <typename F>
+    T Fold(F reducer, const T& startVal) const {
+        T accumulator = startVal;
+        Visit([&reducer, &accumulator](const T& item) {
+            accumulator = reducer(accumulator, item);
+        });
+        return accumulator;
+    }
+};
+
+
+// Restricts templates to sequence types whose calls bind statically.
+template <typename S, typename = void>
+struct IsStaticSequence : std::false_type {};
+
+template <typename S>
+struct IsStaticSequence<S, std::void_t<typename S::value_type>>
+    : std::bool_constant<std::is_final_v<S> && std::is_base_of_v<StaticSequence<S, typename S::value_type>, S>> {};
+
+template <typename S>
+using EnableIfStaticSequence = std::enable_if_t<IsStaticSequence<S>::value>;
@@ -0,0 +1,633 @@
+#pragma once
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "IteratorTraits.hpp"
+#include "Instrumentation.hpp"
+
+
+// Doubly linked list of nodes that each pack up to nodeCapacity elements in a contiguous
+// run. Scans touch one node per nodeCapacity elements, and an insertion shifts at most
+// one node, splitting it in half when it is full.
+template <typename T>
+class UnrolledList {
+public:
+    static constexpr int nodeCapacity = sizeof(T) >= 64 ? 8 : static_cast<int>(512 / sizeof(T));
+
+private:
+    struct Node {
+        Node* next;
+        Node* prev;
+        int count;
+        alignas(T) unsigned char storage[sizeof(T) * nodeCapacity];
+
+        Node() : next(nullptr), prev(nullptr), count(0) {}
+
+        T* items() {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+
+        const T* items() const {
+            return std::launder(reinterpret_cast<const T*>(storage));
+        }
+    };
+
+    Node* head;
+    Node* tail;
+    int size;
+
+    // Last node reached by index and the index of its first element.
+    Node* finger;
+    int fingerStart;
+
+    void _checkException(int index) const {
+        if (index < 0 || index >= size) {
+            throw std::out_of_range("Index out of range");
+        }
+    }
+
+    static void _destroyNode(Node* node) {
+        T* items = node->items();
+        for (int i = 0; i < node->count; ++i) {
+            items[i].~T();
+        }
+        delete node;
+    }
+
+    // Links an empty node after `position`, or at the front when position is null.
+    Node* _linkNodeAfter(Node* position) {
+        Instrument::Allocation(sizeof(Node));
+        Node* node = new Node();
+        node->prev = position;
+        node->next = position == nullptr ? head : position->next;
+        if (node->next != nullptr) {
+            node->next->prev = node;
+        } else {
+            tail = node;
+        }
+        if (position != nullptr) {
+            position->next = node;
+        } else {
+            head = node;
+        }
+        return node;
+    }
+
+    // Finds the node holding `index`, starting from whichever of head, tail and the finger is closest.
+    // Read-only, so concurrent const lookups never write to the list.
+    std::pair<Node*, int> _find(int index) const {
+        Node* node = head;
+        int start = 0;
+        if (index >= size / 2) {
+            node = tail;
+            start = size - tail->count;
+        }
+        if (finger != nullptr) {
+            int fromFinger = fingerStart < index ? index - fingerStart : fingerStart - index;
+            int fromEnd = start < index ? index - start : start - index;
+            if (fromFinger < fromEnd) {
+                node = finger;
+                start = fingerStart;
+            }
+        }
+
+        while (index < start) {
+            node = node->prev;
+            start -= node->count;
+        }
+        while (index >= start + node->count) {
+            start += node->count;
+            node = node->next;
+        }
+        return {node, start};
+    }
+
+    // Lookups on the non-const paths also move the finger to the node they reach.
+    std::pair<Node*, int> _locate(int index) {
+        auto [node, start] = _find(index);
+        finger = node;
+        fingerStart = start;
+        return {node, start};
+    }
+
+    // Moves the upper half of a full node into a new node linked right after it.
+    Node* _splitNode(Node* node) {
+        Node* right = _linkNodeAfter(node);
+        int keep = node->count / 2;
+        Instrument::Relocation<T>(node->count - keep);
+        T* from = node->items();
+        T* to = right->items();
+        for (int i = keep; i < node->count; ++i) {
+            new (to + right->count) T(std::move_if_noexcept(from[i]));
+            ++right->count;
+        }
+        for (int i = keep; i < node->count; ++i) {
+            from[i].~T();
+        }
+        node->count = keep;
+        return right;
+    }
+
+    // Constructs the value at `offset` of a node that has a free slot, shifting the tail of the node right.
+    template <typename... Args>
+    void _emplaceInNode(Node* node, int offset, Args&&... args) {
+        Instrument::Construction<T, Args...>();
+        Instrument::Moves(node->count - offset);
+        T* items = node->items();
+        if (offset == node->count) {
+            new (items + offset) T(std::forward<Args>(args)...);
+        } else {
+            T value(std::forward<Args>(args)...);
+            new (items + node->count) T(std::move(items[node->count - 1]));
+            std::move_backward(items + offset, items + node->count - 1, items + node->count);
+            items[offset] = std::move(value);
+        }
+        ++node->count;
+        ++size;
+    }
+
+    // Unlinks and frees a node; its elements must already be gone.
+    void _unlinkNode(Node* node) {
+        (node->prev != nullptr ? node->prev->next : head) = node->next;
+        (node->next != nullptr ? node->next->prev : tail) = node->prev;
+        if (finger == node) {
+            finger = nullptr;
+        }
+        _destroyNode(node);
+    }
+
+    // Removes `count` elements of a node starting at `offset`, closing the gap.
+    void _eraseInNode(Node* node, int offset, int count) {
+        Instrument::Moves(node->count - offset - count);
+        T* items = node->items();
+        std::move(items + offset + count, items + node->count, items + offset);
+        for (int i = node->count - count; i < node->count; ++i) {
+            items[i].~T();
+        }
+        node->count -= count;
+        size -= count;
+    }
+
+    // Moves every element of `from` to the end of `to`, which must have room for them.
+    static void _moveItems(Node* from, Node* to) {
+        Instrument::Relocation<T>(from->count);
+        T* source = from->items();
+        T* target = to->items();
+        for (int i = 0; i < from->count; ++i) {
+            new (target + to->count) T(std::move_if_noexcept(source[i]));
+            ++to->count;
+        }
+        for (int i = 0; i < from->count; ++i) {
+            source[i].~T();
+        }
+        from->count = 0;
+    }
+
+    // Folds a node that is at most a quarter full into a neighbour with room for it, so
+    // removals cannot leave a long run of nearly empty nodes. The finger stays on the survivor.
+    void _mergeSparse(Node* node, int start) {
+        if (node->count > nodeCapacity / 4) {
+            return;
+        }
+
+        if (node->prev != nullptr && node->prev->count + node->count <= nodeCapacity) {
+            Node* prev = node->prev;
+            int prevStart = start - prev->count;
+            _moveItems(node, prev);
+            _unlinkNode(node);
+            finger = prev;
+            fingerStart = prevStart;
+        } else if (node->next != nullptr && node->count + node->next->count <= nodeCapacity) {
+            _moveItems(node->next, node);
+            _unlinkNode(node->next);
+            finger = node;
+            fingerStart = start;
+        }
+    }
+
+    template <bool IsConst>
+    class UnrolledIterator {
+    private:
+        friend class UnrolledList;
+        template <bool> friend class UnrolledIterator;
+
+        Node* node;
+        int offset;
+        const UnrolledList* list;
+
+        UnrolledIterator(Node* node_, int offset_, const UnrolledList* list_) : node(node_), offset(offset_), list(list_) {}
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+
+        UnrolledIterator() : node(nullptr), offset(0), list(nullptr) {}
+
+        template <bool WasConst, typename = std::enable_if_t<IsConst && !WasConst>>
+        UnrolledIterator(const UnrolledIterator<WasConst>& other) : node(other.node), offset(other.offset), list(other.list) {}
+
+        reference operator*() const {
+            return node->items()[offset];
+        }
+
+        pointer operator->() const {
+            return node->items() + offset;
+        }
+
+        UnrolledIterator& operator++() {
+            if (++offset == node->count) {
+                node = node->next;
+                offset = 0;
+            }
+            return *this;
+        }
+
+        UnrolledIterator operator++(int) {
+            UnrolledIterator ret = *this;
+            ++(*this);
+            return ret;
+        }
+
+        UnrolledIterator& operator--() {
+            if (node == nullptr || offset == 0) {
+                node = node == nullptr ? list->tail : node->prev;
+                offset = node->count;
+            }
+            --offset;
+            return *this;
+        }
+
+        UnrolledIterator operator--(int) {
+            UnrolledIterator ret = *this;
+            --(*this);
+            return ret;
+        }
+
+        bool operator==(const UnrolledIterator& other) const {
+            return node == other.node && offset == other.offset;
+        }
+
+        bool operator!=(const UnrolledIterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+public:
+    using Iterator = UnrolledIterator<false>;
+    using ConstIterator = UnrolledIterator<true>;
+
+    UnrolledList() : head(nullptr), tail(nullptr), size(0), finger(nullptr), fingerStart(0) {}
+
+    UnrolledList(const T* items, int count) : UnrolledList() {
+        for (int i = 0; i < count; ++i) {
+            Append(items[i]);
+        }
+    }
+
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    UnrolledList(InputIterator first, InputIterator last) : UnrolledList() {
+        for (; first != last; ++first) {
+            EmplaceBack(*first);
+        }
+    }
+
+    // Copies node by node, so the copy keeps the same layout.
+    UnrolledList(const UnrolledList& other) : UnrolledList() {
+        try {
+            for (Node* current = other.head; current != nullptr; current = current->next) {
+                Node* node = _linkNodeAfter(tail);
+                Instrument::Copies(current->count);
+                for (int i = 0; i < current->count; ++i) {
+                    new (node->items() + i) T(current->items()[i]);
+                    ++node->count;
+                    ++size;
+                }
+            }
+        } catch (...) {
+            Clear();
+            throw;
+        }
+    }
+
+    UnrolledList(UnrolledList&& other) noexcept
+        : head(other.head), tail(other.tail), size(other.size), finger(other.finger), fingerStart(other.fingerStart) {
+        other.head = other.tail = other.finger = nullptr;
+        other.size = 0;
+    }
+
+    ~UnrolledList() {
+        Clear();
+    }
+
+    UnrolledList& operator=(const UnrolledList& other) {
+        if (this != &other) {
+            UnrolledList copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    UnrolledList& operator=(UnrolledList&& other) noexcept {
+        if (this != &other) {
+            Clear();
+            head = other.head;
+            tail = other.tail;
+            size = other.size;
+            finger = other.finger;
+            fingerStart = other.fingerStart;
+            other.head = other.tail = other.finger = nullptr;
+            other.size = 0;
+        }
+        return *this;
+    }
+
+    void Clear() {
+        while (head != nullptr) {
+            Node* temp = head;
+            head = head->next;
+            _destroyNode(temp);
+        }
+
+        tail = finger = nullptr;
+        size = 0;
+    }
+
+    int GetSize() const {
+        return size;
+    }
+
+    Iterator begin() {
+        return Iterator(head, 0, this);
+    }
+
+    Iterator end() {
+        return Iterator(nullptr, 0, this);
+    }
+
+    ConstIterator begin() const {
+        return ConstIterator(head, 0, this);
+    }
+
+    ConstIterator end() const {
+        return ConstIterator(nullptr, 0, this);
+    }
+
+    // Visits the contiguous run of every node; stops early when the visitor returns false.
+    template <typename Visitor>
+    bool ForEachNode(Visitor&& visitor) const {
+        for (const Node* current = head; current != nullptr; current = current->next) {
+            if (!visitor(current->items(), current->count)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void Append(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void Append(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void Prepend(const T& value) {
+        EmplaceFront(value);
+    }
+
+    void Prepend(T&& value) {
+        EmplaceFront(std::move(value));
+    }
+
+    void InsertAt(const T& item, int index) {
+        EmplaceAt(index, item);
+    }
+
+    void InsertAt(T&& item, int index) {
+        EmplaceAt(index, std::move(item));
+    }
+
+    template <typename... Args>
+    void EmplaceBack(Args&&... args) {
+        if (tail == nullptr || tail->count == nodeCapacity) {
+            T value(std::forward<Args>(args)...);
+            _linkNodeAfter(tail);
+            _emplaceInNode(tail, 0, std::move(value));
+            return;
+        }
+        _emplaceInNode(tail, tail->count, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void EmplaceFront(Args&&... args) {
+        if (head == nullptr || head->count == nodeCapacity) {
+            T value(std::forward<Args>(args)...);
+            _linkNodeAfter(nullptr);
+            _emplaceInNode(head, 0, std::move(value));
+            finger = head;
+            fingerStart = 0;
+            return;
+        }
+        _emplaceInNode(head, 0, std::forward<Args>(args)...);
+        finger = head;
+        fingerStart = 0;
+    }
+
+    template <typename... Args>
+    void EmplaceAt(int index, Args&&... args) {
+        if (index < 0 || index > size) {
+            throw std::out_of_range("Index out of range");
+        }
+        if (index == size) {
+            EmplaceBack(std::forward<Args>(args)...);
+            return;
+        }
+        if (index == 0) {
+            EmplaceFront(std::forward<Args>(args)...);
+            return;
+        }
+
+        T value(std::forward<Args>(args)...);
+        auto [node, start] = _locate(index);
+        if (node->count == nodeCapacity) {
+            Node* right = _splitNode(node);
+            if (index - start >= node->count) {
+                start += node->count;
+                node = right;
+            }
+        }
+        _emplaceInNode(node, index - start, std::move(value));
+        finger = node;
+        fingerStart = start;
+    }
+
+    void PopFront() {
+        if (size == 0)
+            throw std::out_of_range("List is empty");
+        RemoveRange(0, 0);
+    }
+
+    void PopBack() {
+        if (size == 0)
+            throw std::out_of_range("List is empty");
+        RemoveRange(size - 1, size - 1);
+    }
+
+    void RemoveAt(int index) {
+        RemoveRange(index, index);
+    }
+
+    // Erases [startIndex, endIndex] node by node, drops the nodes that become empty and
+    // merges sparse nodes on either side of the gap.
+    void RemoveRange(int startIndex, int endIndex) {
+        _checkException(startIndex);
+        _checkException(endIndex);
+        if (startIndex > endIndex) {
+            throw std::invalid_argument("Invalid range");
+        }
+
+        auto [node, start] = _locate(startIndex);
+        Node* first = node;
+        Node* beforeFirst = node->prev;
+        bool firstSurvives = true;
+        int offset = startIndex - start;
+        int left = endIndex - startIndex + 1;
+        while (left > 0) {
+            int count = std::min(node->count - offset, left);
+            Node* next = node->next;
+            _eraseInNode(node, offset, count);
+            left -= count;
+            if (node->count == 0) {
+                firstSurvives = firstSurvives && node != first;
+                _unlinkNode(node);
+            }
+            node = next;
+            offset = 0;
+        }
+
+        // Nothing before the gap moved, so the node holding startIndex - 1 anchors the finger.
+        finger = nullptr;
+        if (firstSurvives) {
+            finger = first;
+            fingerStart = start;
+        } else if (beforeFirst != nullptr) {
+            finger = beforeFirst;
+            fingerStart = start - beforeFirst->count;
+        }
+        if (size == 0) {
+            return;
+        }
+        if (startIndex < size) {
+            auto [after, afterStart] = _locate(startIndex);
+            _mergeSparse(after, afterStart);
+        }
+        if (startIndex > 0) {
+            auto [before, beforeStart] = _locate(startIndex - 1);
+            _mergeSparse(before, beforeStart);
+        }
+    }
+
+    // Keeps the order of the remaining elements and returns how many were removed.
+    template <typename Predicate>
+    int RemoveIf(Predicate predicate) {
+        finger = nullptr;
+        int removed = 0;
+        Node* node = head;
+        while (node != nullptr) {
+            T* items = node->items();
+            int kept = 0;
+            for (int i = 0; i < node->count; ++i) {
+                if (!predicate(items[i])) {
+                    if (kept != i) {
+                        items[kept] = std::move(items[i]);
+                    }
+                    ++kept;
+                }
+            }
+            removed += node->count - kept;
+            _eraseInNode(node, kept, node->count - kept);
+
+            Node* next = node->next;
+            if (node->count == 0) {
+                _unlinkNode(node);
+            } else if (node->prev != nullptr && node->prev->count + node->count <= nodeCapacity
+                       && std::min(node->prev->count, node->count) <= nodeCapacity / 4) {
+                _moveItems(node, node->prev);
+                _unlinkNode(node);
+            }
+            node = next;
+        }
+        return removed;
+    }
+
+    T& Get(int index) const {
+        _checkException(index);
+        return GetUnchecked(index);
+    }
+
+    T& Get(int index) {
+        _checkException(index);
+        return GetUnchecked(index);
+    }
+
+    T& GetUnchecked(int index) const {
+        auto [node, start] = _find(index);
+        return node->items()[index - start];
+    }
+
+    T& GetUnchecked(int index) {
+        auto [node, start] = _locate(index);
+        return node->items()[index - start];
+    }
+
+    T& GetFirst() const {
+        if (size == 0)
+            throw std::out_of_range("List is empty");
+        return head->items()[0];
+    }
+
+    T& GetLast() const {
+        if (size == 0)
+            throw std::out_of_range("List is empty");
+        return tail->items()[tail->count - 1];
+    }
+
+    UnrolledList* Concat(const UnrolledList* list) const {
+        UnrolledList* result = new UnrolledList(*this);
+        list->ForEachNode([result](const T* items, int count) {
+            for (int i = 0; i < count; ++i) {
+                result->Append(items[i]);
+            }
+            return true;
+        });
+        return result;
+    }
+
+    UnrolledList* GetSubList(int startIndex, int endIndex) const {
+        _checkException(startIndex);
+        _checkException(endIndex);
+
+        UnrolledList* result = new UnrolledList();
+        auto [node, start] = _find(startIndex);
+        ConstIterator current(node, startIndex - start, this);
+        if (startIndex <= endIndex) {
+            for (int i = startIndex; i <= endIndex; ++i, ++current) {
+                result->Append(*current);
+            }
+        } else {
+            for (int i = startIndex; endIndex <= i; --i) {
+                result->Append(*current);
+                if (i > endIndex) --current;
+            }
+        }
+
+        return result;
+    }
+};
@@ -0,0 +1,332 @@
+#pragma once
+#include "UnrolledList.hpp"
+#include "Sequence.hpp"
+
+template <typename T>
+class UnrolledListSequence : public Sequence<T> {
+private:
+    UnrolledList<T>* data;
+
+    virtual Sequence<T>* AppendInternal(const T& item) override {
+        this->data->Append(item);
+        return this;
+    }
+
+    virtual Sequence<T>* AppendInternal(T&& item) override {
+        this->data->Append(std::move(item));
+        return this;
+    }
+
+    virtual Sequence<T>* PrependInternal(const T& item) override {
+        this->data->Prepend(item);
+        return this;
+    }
+
+    virtual Sequence<T>* PrependInternal(T&& item) override {
+        this->data->Prepend(std::move(item));
+        return this;
+    }
+
+    virtual Sequence<T>* InsertAtInternal(const T& item, int index) override {
+        this->data->InsertAt(item, index);
+        return this;
+    }
+
+    virtual Sequence<T>* InsertAtInternal(T&& item, int index) override {
+        this->data->InsertAt(std::move(item), index);
+        return this;
+    }
+
+    virtual Sequence<T>* ConcatInternal(const Sequence<T>* other) override {
+        // Appends never move existing items, so stopping at the entry length lets other be this.
+        int remaining = other->GetLength();
+        other->ForEachChunk([this, &remaining](const T* items, int count) {
+            for (int i = 0; i < count && remaining > 0; ++i, --remaining) {
+                this->data->Append(items[i]);
+            }
+            return remaining > 0;
+        });
+        return this;
+    }
+
+    virtual Sequence<T>* RemoveAtInternal(int index) override {
+        this->data->RemoveAt(index);
+        return this;
+    }
+
+    virtual Sequence<T>* RemoveRangeInternal(int startIndex, int endIndex) override {
+        this->data->RemoveRange(startIndex, endIndex);
+        return this;
+    }
+
+    virtual Sequence<T>* RemoveIfInternal(const std::function<bool(const T&)>& predicate) override {
+        this->data->RemoveIf(predicate);
+        return this;
+    }
+
+protected:
+    virtual Sequence<T>* Instance() = 0;
+    virtual UnrolledListSequence<T>* CreateEmptyUnrolledListSequence() const = 0;
+
+public:
+    UnrolledListSequence() : data(new UnrolledList<T>()) {}
+    UnrolledListSequence(const T* items, int count) : data(new UnrolledList<T>(items, count)) {}
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    UnrolledListSequence(InputIterator first, InputIterator last) : data(new UnrolledList<T>(first, last)) {}
+    UnrolledListSequence(std::initializer_list<T> items) : UnrolledListSequence(items.begin(), static_cast<int>(items.size())) {}
+    UnrolledListSequence(const Sequence<T>& other) : UnrolledListSequence() {
+        other.ForEach([this](const T& item) {
+            this->data->Append(item);
+        });
+    }
+    UnrolledListSequence(UnrolledListSequence<T>&& other) noexcept : data(other.data) {
+        other.data = nullptr;
+    }
+    UnrolledListSequence(const UnrolledListSequence<T>& other) : Sequence<T>(), data(new UnrolledList<T>(*other.data)) {}
+
+    ~UnrolledListSequence() override {
+        delete this->data;
+    }
+
+    UnrolledListSequence<T>& operator=(const UnrolledListSequence<T>& other) {
+        if (this != &other) {
+            UnrolledList<T>* copy = new UnrolledList<T>(*other.data);
+            delete this->data;
+            this->data = copy;
+        }
+        return *this;
+    }
+
+    UnrolledListSequence<T>& operator=(UnrolledListSequence<T>&& other) noexcept {
+        if (this != &other) {
+            delete this->data;
+            this->data = other.data;
+            other.data = nullptr;
+        }
+        return *this;
+    }
+
+    using Iterator = typename UnrolledList<T>::Iterator;
+    using ConstIterator = typename UnrolledList<T>::ConstIterator;
+
+    Iterator begin() {
+        return this->data->begin();
+    }
+
+    Iterator end() {
+        return this->data->end();
+    }
+
+    ConstIterator begin() const {
+        return static_cast<const UnrolledList<T>*>(this->data)->begin();
+    }
+
+    ConstIterator end() const {
+        return static_cast<const UnrolledList<T>*>(this->data)->end();
+    }
+
+    // Every node is reported as one contiguous chunk.
+    bool ForEachChunk(const std::function<bool(const T*, int)>& visitor) const override {
+        return this->VisitChunks(visitor);
+    }
+
+    template <typename Visitor>
+    bool VisitChunks(Visitor&& visitor) const {
+        return static_cast<const UnrolledList<T>*>(this->data)->ForEachNode(std::forward<Visitor>(visitor));
+    }
+
+    int GetLength() const override {
+        return this->data->GetSize();
+    }
+
+    const T& GetFirst() const override {
+        if (this->GetLength() == 0) {
+            throw std::out_of_range("Sequence is empty - cannot get first element");
+        }
+
+        return this->data->GetFirst();
+    }
+
+    const T& GetLast() const override {
+        if (this->GetLength() == 0) {
+            throw std::out_of_range("Sequence is empty - cannot get last element");
+        }
+
+        return this->data->GetLast();
+    }
+
+    const T& Get(int index) const override {
+        if (index < 0 || index >= data->GetSize()) {
+            throw std::out_of_range("Sequence index out of range");
+        }
+
+        return static_cast<const UnrolledList<T>*>(this->data)->GetUnchecked(index);
+    }
+
+    const T& GetUnchecked(int index) const override {
+        return static_cast<const UnrolledList<T>*>(this->data)->GetUnchecked(index);
+    }
+
+    T& GetFirst() override {
+        if (this->GetLength() == 0) {
+            throw std::out_of_range("Sequence is empty - cannot get first element");
+        }
+
+        return this->data->GetFirst();
+    }
+
+    T& GetLast() override {
+        if (this->GetLength() == 0) {
+            throw std::out_of_range("Sequence is empty - cannot get last element");
+        }
+
+        return this->data->GetLast();
+    }
+
+    T& Get(int index) override {
+        if (index < 0 || index >= data->GetSize()) {
+            throw std::out_of_range("Sequence index out of range");
+        }
+
+        return this->data->GetUnchecked(index);
+    }
+
+    T& GetUnchecked(int index) override {
+        return this->data->GetUnchecked(index);
+    }
+
+    T& operator[] (int index) override {
+        return this->data->Get(index);
+    }
+
+    UnrolledListSequence<T>* GetSubsequence(int startIndex, int endIndex) const override {
+        if (std::min(startIndex, endIndex) < 0 || std::max(startIndex, endIndex) >= data->GetSize()) {
+            throw std::out_of_range("UnrolledListSequence index out of range");
+        }
+
+        UnrolledListSequence<T>* ret = this->CreateEmptyUnrolledListSequence();
+        delete ret->data;
+        ret->data = this->data->GetSubList(startIndex, endIndex);
+
+        return ret;
+    }
+
+    virtual Sequence<T>* Append(const T& item) override {
+        return this->Instance()->AppendInternal(item);
+    }
+
+    virtual Sequence<T>* Append(T&& item) override {
+        return this->Instance()->AppendInternal(std::move(item));
+    }
+
+    virtual Sequence<T>* Prepend(const T& item) override {
+        return this->Instance()->PrependInternal(item);
+    }
+
+    virtual Sequence<T>* Prepend(T&& item) override {
+        return this->Instance()->PrependInternal(std::move(item));
+    }
+
+    virtual Sequence<T>* InsertAt(const T& item, int index) override {
+        if (index < 0 || index > this->data->GetSize()) {
+            throw std::out_of_range("Sequence index out of range");
+        }
+        return this->Instance()->InsertAtInternal(item, index);
+    }
+
+    virtual Sequence<T>* InsertAt(T&& item, int index) override {
+        if (index < 0 || index > this->data->GetSize()) {
+            throw std::out_of_range("Sequence index out of range");
+        }
+        return this->Instance()->InsertAtInternal(std::move(item), index);
+    }
+
+    virtual Sequence<T>* Concat(const Sequence<T>* other) override {
+        return this->Instance()->ConcatInternal(other);
+    }
+
+    virtual Sequence<T>* RemoveAt(int index) override {
+        if (index < 0 || index >= this->data->GetSize()) {
+            throw std::out_of_range("Sequence index out of range");
+        }
+        return this->Instance()->RemoveAtInternal(index);
+    }
+
+    virtual Sequence<T>* RemoveRange(int startIndex, int endIndex) override {
+        if (std::min(startIndex, endIndex) < 0 || std::max(startIndex, endIndex) >= this->data->GetSize()) {
+            throw std::out_of_range("Sequence index out of range");
+        }
+        return this->Instance()->RemoveRangeInternal(std::min(startIndex, endIndex), std::max(startIndex, endIndex));
+    }
+
+    virtual Sequence<T>* RemoveIf(const std::function<bool(const T&)>& predicate) override {
+        return this->Instance()->RemoveIfInternal(predicate);
+    }
+};
+
+
+template <typename T>
+class MutableUnrolledListSequence final : public UnrolledListSequence<T>, public StaticSequence<MutableUnrolledListSequence<T>, T> {
+public:
+    using tag = MutableSequenceTag;
+
+    MutableUnrolledListSequence() : UnrolledListSequence<T>() {}
+    MutableUnrolledListSequence(const T* items, int count) : UnrolledListSequence<T>(items, count) {}
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    MutableUnrolledListSequence(InputIterator first, InputIterator last) : UnrolledListSequence<T>(first, last) {}
+    MutableUnrolledListSequence(std::initializer_list<T> items) : UnrolledListSequence<T>(items) {}
+    MutableUnrolledListSequence(const Sequence<T>& other) : UnrolledListSequence<T>(other) {}
+    MutableUnrolledListSequence(const MutableUnrolledListSequence<T>& other) : UnrolledListSequence<T>(other) {}
+    MutableUnrolledListSequence(UnrolledListSequence<T>&& other) : UnrolledListSequence<T>(std::move(other)) {}
+
+    virtual Sequence<T>* CreateEmptySequence() const override {
+        return new MutableUnrolledListSequence<T>();
+    }
+    virtual Sequence<T>* CreateSequence(const T* items, int count) const override {
+        return new MutableUnrolledListSequence<T>(items, count);
+    }
+    virtual UnrolledListSequence<T>* CreateEmptyUnrolledListSequence() const override {
+        return new MutableUnrolledListSequence<T>();
+    }
+    virtual UnrolledListSequence<T>* Instance() override {
+        return this;
+    }
+};
+
+
+// Another name for the shared persistent vector (see PersistentSequence). Its nodes are
+// unrolled: each holds a run of elements, copied on write, so a new version costs
+// O(log N) nodes plus one run instead of a full copy of the list.
+template <typename T>
+class ImmutableUnrolledListSequence final : public PersistentSequence<T>, public StaticSequence<ImmutableUnrolledListSequence<T>, T> {
+private:
+    PersistentSequence<T>* Clone() const {
+        Instrument::Clone();
+        return new ImmutableUnrolledListSequence<T>(*this);
+    }
+
+public:
+    using tag = ImmutableSequenceTag;
+
+    ImmutableUnrolledListSequence() : PersistentSequence<T>() {}
+    ImmutableUnrolledListSequence(const T* items, int count) : PersistentSequence<T>(items, count) {}
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    ImmutableUnrolledListSequence(InputIterator first, InputIterator last) : PersistentSequence<T>(first, last) {}
+    ImmutableUnrolledListSequence(std::initializer_list<T> items) : PersistentSequence<T>(items) {}
+    ImmutableUnrolledListSequence(const Sequence<T>& other) : PersistentSequence<T>(other) {}
+    ImmutableUnrolledListSequence(const ImmutableUnrolledListSequence<T>& other) : PersistentSequence<T>(other) {}
+    ImmutableUnrolledListSequence(ImmutableUnrolledListSequence<T>&& other) noexcept : PersistentSequence<T>(std::move(other)) {}
+
+    virtual Sequence<T>* CreateEmptySequence() const override {
+        return new ImmutableUnrolledListSequence<T>();
+    }
+    virtual Sequence<T>* CreateSequence(const T* items, int count) const override {
+        return new ImmutableUnrolledListSequence<T>(items, count);
+    }
+    virtual PersistentSequence<T>* CreateEmptyPersistentSequence() const override {
+        return new ImmutableUnrolledListSequence<T>();
+    }
+    virtual PersistentSequence<T>* Instance() override {
+        return Clone();
+    }
+};
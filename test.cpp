@@ -4,6 +4,8 @@
 #include "headers/SequenceTester.hpp"
 #include "headers/SegmentedSequence.hpp"
 #include "headers/AdaptiveSequence.hpp"
+#include "headers/UnrolledListSequence.hpp"
+#include "headers/SequenceView.hpp"
 
 
 int main() {